@@ -0,0 +1,14 @@
+#include "display_bench.hpp"
+#include "esp_log.h"
+#include "host_rtos.hpp"
+
+// Runs display_benchmark() on the host against the real drawing code. The
+// panel is a stub, so only the back buffer work is timed.
+
+int main() {
+  esp_log_level_set("*", ESP_LOG_INFO);
+  host_use_wall_clock(true);
+  Adafruit_SSD1680 display(EPD_WIDTH, EPD_HEIGHT, nullptr, nullptr, nullptr);
+  display_benchmark(&display);
+  return 0;
+}
@@ -0,0 +1,280 @@
+#include "host_rtos.hpp"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <chrono>
+#include <deque>
+#include <map>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+struct HostQueue {
+  size_t length;
+  size_t item_size;
+  std::deque<std::vector<uint8_t>> items;
+};
+
+struct HostSemaphore {
+  UBaseType_t count;
+};
+
+// Thrown out of the task once it would wait past the end of host_run
+struct HostStop {};
+
+static int64_t now_us;
+static int64_t end_us = INT64_MAX;
+static std::multimap<int64_t, std::function<void()>> actions;
+static TaskFunction_t task_entry;
+static void *task_arg;
+static std::vector<HostQueue *> queues;
+static uint32_t notify_count;
+static bool wall_clock;
+static esp_log_level_t log_level = ESP_LOG_WARN;
+
+/**
+ * @brief Move the clock forward, running the actions due on the way
+ * @param time_us Time to move to
+ * @param wake Stop early once this returns true after an action
+ * @return True if wake ended the step early
+ */
+static bool advance(int64_t time_us, const std::function<bool()> &wake) {
+  while (!actions.empty() && actions.begin()->first <= time_us &&
+         actions.begin()->first <= end_us) {
+    auto first = actions.begin();
+    if (first->first > now_us) {
+      now_us = first->first;
+    }
+    std::function<void()> action = std::move(first->second);
+    actions.erase(first);
+    action();
+    if (wake && wake()) {
+      return true;
+    }
+  }
+  if (time_us > end_us) {
+    now_us = end_us;
+    throw HostStop();
+  }
+  if (time_us > now_us) {
+    now_us = time_us;
+  }
+  return false;
+}
+
+// Time of the tick boundary a number of ticks from now
+static int64_t tick_time(TickType_t ticks) {
+  return (now_us / HOST_TICK_US + (int64_t)ticks) * HOST_TICK_US;
+}
+
+void host_reset() {
+  now_us = 0;
+  end_us = INT64_MAX;
+  actions.clear();
+  task_entry = nullptr;
+  task_arg = nullptr;
+  for (HostQueue *queue : queues) {
+    delete queue;
+  }
+  queues.clear();
+  notify_count = 0;
+}
+
+int64_t host_time_us() { return now_us; }
+
+void host_at(int64_t time_us, std::function<void()> action) {
+  actions.emplace(time_us, std::move(action));
+}
+
+void host_run(int64_t duration_us) {
+  if (!task_entry) {
+    return;
+  }
+  end_us = now_us + duration_us;
+  try {
+    task_entry(task_arg);
+  } catch (const HostStop &) {
+  }
+  end_us = INT64_MAX;
+}
+
+void host_use_wall_clock(bool enable) { wall_clock = enable; }
+
+int64_t esp_timer_get_time(void) {
+  if (wall_clock) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+  return now_us;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t entry, const char *name,
+                       uint32_t stack_depth, void *arg, UBaseType_t priority,
+                       TaskHandle_t *handle) {
+  task_entry = entry;
+  task_arg = arg;
+  if (handle) {
+    *handle = (TaskHandle_t)entry;
+  }
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {}
+
+void vTaskDelay(TickType_t ticks) {
+  if (ticks > 0) {
+    advance(tick_time(ticks), nullptr);
+  }
+}
+
+TickType_t xTaskGetTickCount(void) {
+  return (TickType_t)(now_us / HOST_TICK_US);
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value,
+                       eNotifyAction action) {
+  return pdPASS;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value,
+                              eNotifyAction action, BaseType_t *woken) {
+  return pdPASS;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  notify_count++;
+  return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait) {
+  if (notify_count == 0 && ticks_to_wait > 0) {
+    int64_t deadline = (ticks_to_wait == portMAX_DELAY)
+                           ? INT64_MAX
+                           : tick_time(ticks_to_wait);
+    advance(deadline, [] { return notify_count > 0; });
+  }
+  uint32_t count = notify_count;
+  notify_count = clear_on_exit ? 0 : (count ? count - 1 : 0);
+  return count;
+}
+
+// Semaphores are not tracked by host_reset, the code under test deletes
+// its own
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+  return new HostSemaphore{1};
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+  return new HostSemaphore{0};
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore,
+                          TickType_t ticks_to_wait) {
+  if (semaphore->count == 0 && ticks_to_wait > 0) {
+    int64_t deadline = (ticks_to_wait == portMAX_DELAY)
+                           ? INT64_MAX
+                           : tick_time(ticks_to_wait);
+    advance(deadline, [semaphore] { return semaphore->count > 0; });
+  }
+  if (semaphore->count == 0) {
+    return pdFALSE;
+  }
+  semaphore->count--;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  semaphore->count = 1;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore,
+                                 BaseType_t *woken) {
+  return xSemaphoreGive(semaphore);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) { delete semaphore; }
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+  queues.push_back(new HostQueue{length, item_size, {}});
+  return queues.back();
+}
+
+// Nothing else runs while the caller waits, a full queue stays full
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item,
+                      TickType_t ticks_to_wait) {
+  if (queue->items.size() >= queue->length) {
+    return errQUEUE_FULL;
+  }
+  const uint8_t *bytes = (const uint8_t *)item;
+  queue->items.emplace_back(bytes, bytes + queue->item_size);
+  return pdTRUE;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item,
+                             BaseType_t *woken) {
+  return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item,
+                         TickType_t ticks_to_wait) {
+  if (queue->items.empty() && ticks_to_wait > 0) {
+    int64_t deadline = (ticks_to_wait == portMAX_DELAY)
+                           ? INT64_MAX
+                           : tick_time(ticks_to_wait);
+    advance(deadline, [queue] { return !queue->items.empty(); });
+  }
+  if (queue->items.empty()) {
+    return pdFALSE;
+  }
+  memcpy(item, queue->items.front().data(), queue->item_size);
+  queue->items.pop_front();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  return (UBaseType_t)queue->items.size();
+}
+
+const char *esp_err_to_name(esp_err_t code) {
+  switch (code) {
+  case ESP_OK:
+    return "ESP_OK";
+  case ESP_FAIL:
+    return "ESP_FAIL";
+  case ESP_ERR_NO_MEM:
+    return "ESP_ERR_NO_MEM";
+  case ESP_ERR_INVALID_ARG:
+    return "ESP_ERR_INVALID_ARG";
+  case ESP_ERR_INVALID_STATE:
+    return "ESP_ERR_INVALID_STATE";
+  case ESP_ERR_TIMEOUT:
+    return "ESP_ERR_TIMEOUT";
+  default:
+    return "UNKNOWN ERROR";
+  }
+}
+
+void esp_log_level_set(const char *tag, esp_log_level_t level) {
+  log_level = level;
+}
+
+void host_log(esp_log_level_t level, const char *tag, const char *format,
+              ...) {
+  if (level > log_level) {
+    return;
+  }
+  static const char letters[] = "NEWIDV";
+  printf("%c (%lld) %s: ", letters[level], (long long)(now_us / 1000), tag);
+  va_list args;
+  va_start(args, format);
+  vprintf(format, args);
+  va_end(args);
+  printf("\n");
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "sdkconfig.h"
+#include <functional>
+#include <stdint.h>
+
+/**
+ * @brief Discrete event stand-in for FreeRTOS and esp_timer
+ *
+ * The sensor task runs on the calling thread against a virtual clock. A
+ * delay or a blocking queue receive jumps the clock forward instead of
+ * sleeping, so an hour of sensor operation takes milliseconds and every run
+ * is repeatable. Work of other tasks, e.g. a UI submitting a command, is
+ * scheduled with host_at() and runs when the clock reaches its time.
+ */
+
+// Tick length, CONFIG_FREERTOS_HZ ticks per second
+#define HOST_TICK_US (1000000LL / CONFIG_FREERTOS_HZ)
+
+/**
+ * @brief Rewind the clock to zero and drop scheduled actions, the task and
+ * all queues
+ */
+void host_reset();
+
+int64_t host_time_us();
+
+/**
+ * @brief Run an action once the clock reaches a time
+ * @param time_us Virtual time, actions in the past run at the next step
+ */
+void host_at(int64_t time_us, std::function<void()> action);
+
+/**
+ * @brief Run the task created by xTaskCreate for a span of virtual time
+ *
+ * The task is entered from the start, so call this once per task. It
+ * returns at the first delay or queue wait that would pass the end.
+ * @param duration_us Virtual time to run for
+ */
+void host_run(int64_t duration_us);
+
+/**
+ * @brief Make esp_timer_get_time() read the host's monotonic clock
+ *
+ * For benchmarks, which time real work instead of virtual delays.
+ */
+void host_use_wall_clock(bool enable);
@@ -0,0 +1,154 @@
+#pragma once
+
+// Host stand-in for the Adafruit GFX base class. Only the members the
+// display code uses are here. The generic paths draw pixel by pixel like
+// the library does, so they stay a fair baseline for the byte-wide ones.
+
+#include "gfxfont.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+class Adafruit_GFX {
+public:
+  Adafruit_GFX(int16_t w, int16_t h)
+      : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+  virtual ~Adafruit_GFX() {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+  virtual void startWrite() {}
+  virtual void writePixel(int16_t x, int16_t y, uint16_t color) {
+    drawPixel(x, y, color);
+  }
+  virtual void endWrite() {}
+
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h,
+                             uint16_t color) {
+    for (int16_t i = 0; i < h; i++) {
+      drawPixel(x, y + i, color);
+    }
+  }
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w,
+                             uint16_t color) {
+    for (int16_t i = 0; i < w; i++) {
+      drawPixel(x + i, y, color);
+    }
+  }
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                        uint16_t color) {
+    for (int16_t i = x; i < x + w; i++) {
+      drawFastVLine(i, y, h, color);
+    }
+  }
+  virtual void fillScreen(uint16_t color) {
+    fillRect(0, 0, _width, _height, color);
+  }
+
+  // Custom font handling of the library's write(), the classic font is not
+  // supported
+  virtual size_t write(uint8_t c) {
+    if (!gfxFont) {
+      return 1;
+    }
+    if (c == '\n') {
+      cursor_x = 0;
+      cursor_y += (int16_t)textsize_y * gfxFont->yAdvance;
+    } else if (c != '\r' && c >= gfxFont->first && c <= gfxFont->last) {
+      const GFXglyph *glyph = gfxFont->glyph + (c - gfxFont->first);
+      if (glyph->width > 0 && glyph->height > 0) {
+        if (wrap && cursor_x + glyph->xOffset + glyph->width > _width) {
+          cursor_x = 0;
+          cursor_y += (int16_t)textsize_y * gfxFont->yAdvance;
+        }
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x,
+                 textsize_y);
+      }
+      cursor_x += glyph->xAdvance * (int16_t)textsize_x;
+    }
+    return 1;
+  }
+  size_t write(const char *str) {
+    size_t n = 0;
+    while (*str) {
+      n += write((uint8_t)*str++);
+    }
+    return n;
+  }
+  size_t print(const char *str) { return write(str); }
+
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                uint16_t bg, uint8_t size_x, uint8_t size_y) {
+    const GFXglyph *glyph = gfxFont->glyph + (c - gfxFont->first);
+    const uint8_t *bitmap = gfxFont->bitmap;
+    uint16_t offset = glyph->bitmapOffset;
+    uint8_t bits = 0, bit = 0;
+    startWrite();
+    for (uint8_t yy = 0; yy < glyph->height; yy++) {
+      for (uint8_t xx = 0; xx < glyph->width; xx++) {
+        if (!(bit++ & 7)) {
+          bits = bitmap[offset++];
+        }
+        if (bits & 0x80) {
+          writePixel(x + glyph->xOffset + xx, y + glyph->yOffset + yy, color);
+        }
+        bits <<= 1;
+      }
+    }
+    endWrite();
+  }
+
+  void getTextBounds(const char *str, int16_t x, int16_t y, int16_t *x1,
+                     int16_t *y1, uint16_t *w, uint16_t *h) {
+    int16_t minx = INT16_MAX, miny = INT16_MAX, maxx = -1, maxy = -1;
+    for (; gfxFont && *str; str++) {
+      uint8_t c = *str;
+      if (c < gfxFont->first || c > gfxFont->last) {
+        continue;
+      }
+      const GFXglyph *glyph = gfxFont->glyph + (c - gfxFont->first);
+      int16_t gx0 = x + glyph->xOffset, gy0 = y + glyph->yOffset;
+      int16_t gx1 = gx0 + glyph->width - 1, gy1 = gy0 + glyph->height - 1;
+      if (glyph->width > 0 && glyph->height > 0) {
+        minx = gx0 < minx ? gx0 : minx;
+        miny = gy0 < miny ? gy0 : miny;
+        maxx = gx1 > maxx ? gx1 : maxx;
+        maxy = gy1 > maxy ? gy1 : maxy;
+      }
+      x += glyph->xAdvance;
+    }
+    *x1 = maxx >= minx ? minx : x;
+    *y1 = maxy >= miny ? miny : y;
+    *w = maxx >= minx ? maxx - minx + 1 : 0;
+    *h = maxy >= miny ? maxy - miny + 1 : 0;
+  }
+
+  void setRotation(uint8_t r) {
+    rotation = r & 3;
+    _width = (rotation & 1) ? HEIGHT : WIDTH;
+    _height = (rotation & 1) ? WIDTH : HEIGHT;
+  }
+  uint8_t getRotation() const { return rotation; }
+  void setCursor(int16_t x, int16_t y) {
+    cursor_x = x;
+    cursor_y = y;
+  }
+  void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+  void setTextColor(uint16_t c, uint16_t bg) {
+    textcolor = c;
+    textbgcolor = bg;
+  }
+  void setTextWrap(bool w) { wrap = w; }
+  void setFont(const GFXfont *f) { gfxFont = (GFXfont *)f; }
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+
+protected:
+  const int16_t WIDTH, HEIGHT;
+  int16_t _width, _height;
+  int16_t cursor_x = 0, cursor_y = 0;
+  uint16_t textcolor = 0xFFFF, textbgcolor = 0xFFFF;
+  uint8_t textsize_x = 1, textsize_y = 1;
+  uint8_t rotation = 0;
+  bool wrap = true;
+  GFXfont *gfxFont = nullptr;
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+// Host stand-in for the Adafruit GFX FreeSans7pt7b font, which is not part
+// of this tree. Glyph sizes follow a 7pt sans font with a 17 pixel line,
+// the bitmaps are filler, so text timings only approximate the real font.
+
+#include "gfxfont.h"
+
+static uint8_t FreeSans7pt7bBitmaps[] = {
+    0x24, 0x93, 0x84, 0x01, 0x01, 0x05, 0x83, 0xA1, 0x08, 0x02, 0xA0, 0x80,
+    0x91, 0x88, 0x11, 0xAE, 0x44, 0x95, 0x54, 0x82, 0x86, 0x89, 0x93, 0xAB,
+    0x86, 0x83, 0x83, 0x82, 0x51, 0x98, 0x45, 0x97, 0xC1, 0x01, 0xB3, 0x00,
+    0xA3, 0x00, 0x8A, 0x1D, 0x05, 0x21, 0xE4, 0x5F, 0x22, 0x84, 0x01, 0xA0,
+    0x8A, 0x61, 0x05, 0xA2, 0x03, 0x94, 0x41, 0xA1, 0x9C, 0xA0, 0x83, 0x87,
+    0x0D, 0xC7, 0xD3, 0x8C, 0x64, 0x9A, 0x06, 0x34, 0x09, 0x09, 0x00, 0x89,
+    0x1D, 0x13, 0x00, 0xD0, 0x59, 0x19, 0xFB, 0x7B, 0x04, 0x97, 0xC2, 0xA1,
+    0x85, 0xA1, 0x82, 0x84, 0x85, 0x90, 0x84, 0x8B, 0x88, 0x80, 0xA0, 0x8D,
+    0xA5, 0xB2, 0xDB, 0x05, 0x42, 0x81, 0x90, 0xC3, 0xF1, 0x10, 0x38, 0x15,
+    0x9C, 0x94, 0xE9, 0xC8, 0x95, 0x09, 0x63, 0xCA, 0x95, 0xF0, 0x64, 0xB3,
+    0x29, 0x21, 0x87, 0x87, 0x90, 0xF8, 0x49, 0x8D, 0x81, 0xB8, 0x83, 0x23,
+    0xDD, 0xD3, 0x00, 0x81, 0xC3, 0x41, 0x89, 0x81, 0x85, 0xC2, 0x80, 0x81,
+    0x40, 0x81, 0xA0, 0x0F, 0x85, 0x8A, 0x0E, 0x83, 0x03, 0xC1, 0xD1, 0x81,
+    0x83, 0xC2, 0x88, 0x81, 0x80, 0xE1, 0x8C, 0xB1, 0x22, 0x05, 0x91, 0x2D,
+    0x23, 0x89, 0x86, 0xA5, 0x80, 0x23, 0xB9, 0x80, 0xA9, 0x81, 0x20, 0x83,
+    0x42, 0x51, 0x85, 0xF0, 0x00, 0x85, 0x81, 0x9D, 0x88, 0x01, 0x41, 0xC7,
+    0x81, 0xC9, 0x81, 0x42, 0x89, 0x93, 0x13, 0x8C, 0xAD, 0x80, 0x83, 0x81,
+    0x19, 0x41, 0x00, 0x8C, 0xE8, 0x01, 0x90, 0x01, 0xA2, 0x00, 0x82, 0xC2,
+    0x2D, 0x48, 0x41, 0x81, 0x88, 0x01, 0x63, 0x80, 0x28, 0x81, 0xE1, 0xB1,
+    0x12, 0xC1, 0xA3, 0x65, 0x89, 0x01, 0xA1, 0x41, 0x84, 0x81, 0xC9, 0x31,
+    0x01, 0x00, 0x01, 0xD4, 0x8C, 0x89, 0x41, 0x0A, 0x41, 0x81, 0xB3, 0x01,
+    0x41, 0xA4, 0x01, 0xCD, 0x91, 0x85, 0x80, 0xA4, 0x81, 0xB8, 0x81, 0x85,
+    0x83, 0xA5, 0xA1, 0x83, 0xA0, 0x81, 0xD1, 0x83, 0xC4, 0xA5, 0x21, 0x02,
+    0x81, 0x81, 0x02, 0x80, 0x3D, 0x80, 0x91, 0x81, 0x80, 0x90, 0xC1, 0x40,
+    0x80, 0xB9, 0x71, 0x41, 0xE9, 0x41, 0x81, 0x11, 0xC0, 0xB1, 0x91, 0x03,
+    0xC4, 0x89, 0x25, 0x80, 0x77, 0x84, 0x85, 0x4B, 0x69, 0x41, 0x81, 0xF2,
+    0x41, 0xE2, 0x11, 0xA4, 0x43, 0x81, 0x81, 0x80, 0x19, 0xE0, 0x04, 0xF1,
+    0x63, 0x20, 0x40, 0x16, 0x80, 0x57, 0x91, 0x82, 0x08, 0x10, 0xE3, 0x12,
+    0xED, 0x42, 0x03, 0x81, 0x38, 0x02, 0x01, 0xC1, 0x83, 0x80, 0xE0, 0x8C,
+    0x10, 0x91, 0xA0, 0x48, 0xE9, 0x20, 0x42, 0xC1, 0xB9, 0xC3, 0x0D, 0x8A,
+    0x8A, 0x91, 0xC7, 0x09, 0xC1, 0x43, 0x01, 0x16, 0x07, 0x11, 0x81, 0x81,
+    0x48, 0xA8, 0x21, 0x41, 0xC7, 0x54, 0x81, 0x80, 0x85, 0x22, 0x20, 0xC5,
+    0xD1, 0x00, 0xA5, 0xC5, 0x97, 0x80, 0xED, 0x83, 0x71, 0x09, 0xA7, 0xA9,
+    0xD1, 0x85, 0x80, 0xA1, 0x89, 0x85, 0x20, 0x83, 0x10, 0x81, 0x21, 0x01,
+    0xD1, 0xC2, 0x00, 0x05, 0xA4, 0x05, 0xE2, 0x00, 0xA8, 0x1A, 0x00, 0x23,
+    0x24, 0xC9, 0x81, 0xB4, 0x83, 0x11, 0x80, 0x43, 0x93, 0x8D, 0x38, 0xA8,
+    0x91, 0x65, 0x80, 0x21, 0x05, 0xE1, 0xA2, 0x94, 0x00, 0xA7, 0x87, 0x8B,
+    0x41, 0x55, 0x0B, 0x04, 0xE0, 0x8F, 0x01, 0xC0, 0xC3, 0x06, 0x30, 0x8A,
+    0x11, 0xA5, 0x01, 0x8F, 0x44, 0x00, 0x81, 0x81, 0x81, 0x55, 0xD5, 0x83,
+    0xB1, 0x44, 0x81, 0x88, 0xA3, 0x81, 0x99, 0xF4, 0xC2, 0x40, 0x51, 0x6D,
+    0x80, 0x91, 0x02, 0x51, 0xD4, 0x88, 0x02, 0x01, 0x00, 0x89, 0x81, 0x60,
+    0x11, 0x15, 0x09, 0xB5, 0x28, 0xE0, 0xA4, 0x89, 0x82, 0x87, 0xC3, 0x45,
+    0x00, 0x31, 0x3D, 0xC0, 0x10, 0xC0, 0x80, 0xA2, 0x01, 0x09, 0x81, 0xD2,
+    0x8A, 0x0B, 0x81, 0xD1, 0x21, 0x83, 0x12, 0xC6, 0x01, 0x81, 0x19, 0x09,
+    0x00, 0x89, 0xA0, 0x81, 0xC1, 0x8F, 0x03, 0xCA, 0x10, 0x09, 0x89, 0x81,
+    0x21, 0x68, 0x0A, 0x05, 0x90, 0x6A, 0xC5, 0xCD, 0xA0, 0xA5, 0x81, 0x8C,
+    0x87, 0x41, 0x01, 0x81, 0x84, 0x84, 0x8D, 0x81, 0x01, 0x81, 0x11, 0xC0,
+    0xC2, 0x00, 0xE9, 0x81, 0xA1, 0x86, 0x91, 0xA1, 0xC9, 0x85, 0x11, 0x01,
+    0x82, 0x00, 0x1B, 0xB9, 0x83, 0x82, 0x83, 0x81, 0x07, 0x05, 0xE0, 0xD2,
+    0x80, 0x7D,
+};
+
+// Offset, width, height, advance, x offset, y offset
+static GFXglyph FreeSans7pt7bGlyphs[] = {
+    {0, 0, 0, 4, 0, 0}, // 0x20
+    {0, 3, 4, 4, 0, -10}, // 0x21
+    {2, 1, 7, 3, 0, -10}, // 0x22
+    {3, 5, 5, 6, 0, -10}, // 0x23
+    {7, 1, 5, 3, 0, -10}, // 0x24
+    {8, 1, 8, 3, 0, -10}, // 0x25
+    {9, 1, 10, 3, 0, -10}, // 0x26
+    {11, 1, 6, 3, 0, -10}, // 0x27
+    {12, 2, 3, 3, 0, -10}, // 0x28
+    {13, 2, 7, 3, 0, -10}, // 0x29
+    {15, 5, 5, 6, 0, -10}, // 0x2A
+    {19, 2, 4, 3, 0, -10}, // 0x2B
+    {20, 1, 6, 3, 0, -10}, // 0x2C
+    {21, 3, 9, 4, 0, -10}, // 0x2D
+    {25, 4, 8, 5, 0, -10}, // 0x2E
+    {29, 6, 7, 7, 0, -10}, // 0x2F
+    {35, 9, 10, 10, 0, -10}, // 0x30
+    {47, 8, 10, 9, 0, -10}, // 0x31
+    {57, 8, 10, 9, 0, -10}, // 0x32
+    {67, 6, 10, 7, 0, -10}, // 0x33
+    {75, 8, 10, 9, 0, -10}, // 0x34
+    {85, 8, 10, 9, 0, -10}, // 0x35
+    {95, 7, 10, 8, 0, -10}, // 0x36
+    {104, 8, 10, 9, 0, -10}, // 0x37
+    {114, 7, 10, 8, 0, -10}, // 0x38
+    {123, 9, 10, 10, 0, -10}, // 0x39
+    {135, 3, 10, 4, 0, -10}, // 0x3A
+    {139, 3, 9, 4, 0, -10}, // 0x3B
+    {143, 2, 10, 3, 0, -10}, // 0x3C
+    {146, 2, 4, 3, 0, -10}, // 0x3D
+    {147, 6, 3, 7, 0, -10}, // 0x3E
+    {150, 1, 10, 3, 0, -10}, // 0x3F
+    {152, 1, 10, 3, 0, -10}, // 0x40
+    {154, 6, 10, 7, 0, -10}, // 0x41
+    {162, 8, 10, 9, 0, -10}, // 0x42
+    {172, 8, 10, 9, 0, -10}, // 0x43
+    {182, 8, 10, 9, 0, -10}, // 0x44
+    {192, 8, 10, 9, 0, -10}, // 0x45
+    {202, 6, 10, 7, 0, -10}, // 0x46
+    {210, 7, 10, 8, 0, -10}, // 0x47
+    {219, 6, 10, 7, 0, -10}, // 0x48
+    {227, 8, 10, 9, 0, -10}, // 0x49
+    {237, 9, 10, 10, 0, -10}, // 0x4A
+    {249, 9, 10, 10, 0, -10}, // 0x4B
+    {261, 8, 10, 9, 0, -10}, // 0x4C
+    {271, 6, 10, 7, 0, -10}, // 0x4D
+    {279, 6, 10, 7, 0, -10}, // 0x4E
+    {287, 6, 10, 7, 0, -10}, // 0x4F
+    {295, 7, 10, 8, 0, -10}, // 0x50
+    {304, 8, 10, 9, 0, -10}, // 0x51
+    {314, 7, 10, 8, 0, -10}, // 0x52
+    {323, 6, 10, 7, 0, -10}, // 0x53
+    {331, 7, 10, 8, 0, -10}, // 0x54
+    {340, 7, 10, 8, 0, -10}, // 0x55
+    {349, 9, 10, 10, 0, -10}, // 0x56
+    {361, 7, 10, 8, 0, -10}, // 0x57
+    {370, 8, 10, 9, 0, -10}, // 0x58
+    {380, 7, 10, 8, 0, -10}, // 0x59
+    {389, 6, 10, 7, 0, -10}, // 0x5A
+    {397, 6, 9, 7, 0, -10}, // 0x5B
+    {404, 6, 3, 7, 0, -10}, // 0x5C
+    {407, 2, 2, 3, 0, -10}, // 0x5D
+    {408, 4, 6, 5, 0, -10}, // 0x5E
+    {411, 5, 5, 6, 0, -10}, // 0x5F
+    {415, 6, 8, 7, 0, -10}, // 0x60
+    {421, 5, 7, 6, 0, -7}, // 0x61
+    {426, 6, 10, 7, 0, -10}, // 0x62
+    {434, 5, 7, 6, 0, -7}, // 0x63
+    {439, 3, 10, 4, 0, -10}, // 0x64
+    {443, 5, 7, 6, 0, -7}, // 0x65
+    {448, 5, 10, 6, 0, -10}, // 0x66
+    {455, 6, 10, 7, 0, -7}, // 0x67
+    {463, 3, 10, 4, 0, -10}, // 0x68
+    {467, 7, 7, 8, 0, -7}, // 0x69
+    {474, 5, 10, 6, 0, -7}, // 0x6A
+    {481, 5, 10, 6, 0, -10}, // 0x6B
+    {488, 6, 10, 7, 0, -10}, // 0x6C
+    {496, 6, 7, 7, 0, -7}, // 0x6D
+    {502, 6, 7, 7, 0, -7}, // 0x6E
+    {508, 7, 7, 8, 0, -7}, // 0x6F
+    {515, 5, 10, 6, 0, -7}, // 0x70
+    {522, 5, 10, 6, 0, -7}, // 0x71
+    {529, 6, 7, 7, 0, -7}, // 0x72
+    {535, 5, 7, 6, 0, -7}, // 0x73
+    {540, 4, 10, 5, 0, -10}, // 0x74
+    {545, 6, 7, 7, 0, -7}, // 0x75
+    {551, 5, 7, 6, 0, -7}, // 0x76
+    {556, 5, 7, 6, 0, -7}, // 0x77
+    {561, 5, 7, 6, 0, -7}, // 0x78
+    {566, 5, 10, 6, 0, -7}, // 0x79
+    {573, 7, 7, 8, 0, -7}, // 0x7A
+    {580, 2, 2, 3, 0, -10}, // 0x7B
+    {581, 6, 2, 7, 0, -10}, // 0x7C
+    {583, 4, 10, 5, 0, -10}, // 0x7D
+    {588, 4, 4, 5, 0, -10}, // 0x7E
+};
+
+static const GFXfont FreeSans7pt7b = {FreeSans7pt7bBitmaps,
+                                     FreeSans7pt7bGlyphs, 0x20, 0x7E, 17};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "esp_err.h"
+
+typedef enum { GPIO_NUM_42 = 42 } gpio_num_t;
+typedef enum { GPIO_MODE_OUTPUT = 2 } gpio_mode_t;
+
+static inline esp_err_t gpio_reset_pin(gpio_num_t pin) { return ESP_OK; }
+static inline esp_err_t gpio_set_direction(gpio_num_t pin, gpio_mode_t mode) {
+  return ESP_OK;
+}
+static inline esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level) {
+  return ESP_OK;
+}
+static inline esp_err_t gpio_install_isr_service(int flags) { return ESP_OK; }
@@ -0,0 +1,19 @@
+#pragma once
+
+// Host heap, every capability is plain malloc
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+
+static inline void *heap_caps_malloc(size_t size, uint32_t caps) {
+  return malloc(size);
+}
+
+static inline void *heap_caps_malloc_prefer(size_t size, size_t num, ...) {
+  return malloc(size);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// Host panel IO, every transfer succeeds without going anywhere
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct HostPanelIo *esp_lcd_panel_io_handle_t;
+typedef struct HostPanel *esp_lcd_panel_handle_t;
+typedef int esp_lcd_spi_bus_handle_t;
+
+typedef struct {
+  int cs_gpio_num;
+  int dc_gpio_num;
+  int spi_mode;
+  unsigned int pclk_hz;
+  size_t trans_queue_depth;
+  int lcd_cmd_bits;
+  int lcd_param_bits;
+} esp_lcd_panel_io_spi_config_t;
+
+static inline esp_err_t
+esp_lcd_new_panel_io_spi(esp_lcd_spi_bus_handle_t bus,
+                         const esp_lcd_panel_io_spi_config_t *config,
+                         esp_lcd_panel_io_handle_t *io) {
+  *io = nullptr;
+  return ESP_OK;
+}
+
+static inline esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io,
+                                                  int cmd, const void *param,
+                                                  size_t size) {
+  return ESP_OK;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "esp_lcd_panel_io.h"
+
+static inline esp_err_t esp_lcd_panel_reset(esp_lcd_panel_handle_t panel) {
+  return ESP_OK;
+}
+static inline esp_err_t esp_lcd_panel_init(esp_lcd_panel_handle_t panel) {
+  return ESP_OK;
+}
+static inline esp_err_t esp_lcd_panel_disp_on_off(esp_lcd_panel_handle_t panel,
+                                                  bool on) {
+  return ESP_OK;
+}
+static inline esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel,
+                                                  int x_start, int y_start,
+                                                  int x_end, int y_end,
+                                                  const void *data) {
+  return ESP_OK;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "esp_lcd_panel_vendor.h"
+#include <stdbool.h>
+
+typedef struct {
+  int busy_gpio_num;
+  bool non_copy_mode;
+} esp_lcd_ssd1680_config_t;
+
+typedef bool (*epaper_panel_cb_t)(const esp_lcd_panel_handle_t handle,
+                                  const void *edata, void *user_data);
+
+typedef struct {
+  epaper_panel_cb_t on_epaper_refresh_done;
+} epaper_panel_callbacks_t;
+
+static inline esp_err_t
+esp_lcd_new_panel_ssd1680(esp_lcd_panel_io_handle_t io,
+                          const esp_lcd_panel_dev_config_t *config,
+                          esp_lcd_panel_handle_t *panel) {
+  *panel = nullptr;
+  return ESP_OK;
+}
+static inline esp_err_t
+epaper_panel_register_event_callbacks(esp_lcd_panel_handle_t panel,
+                                      epaper_panel_callbacks_t *cbs,
+                                      void *user_data) {
+  return ESP_OK;
+}
+static inline esp_err_t epaper_panel_set_refresh_mode(
+    esp_lcd_panel_handle_t panel, bool full_refresh) {
+  return ESP_OK;
+}
+static inline esp_err_t
+epaper_panel_refresh_screen(esp_lcd_panel_handle_t panel) {
+  return ESP_OK;
+}
+static inline esp_err_t epaper_panel_set_custom_lut(
+    esp_lcd_panel_handle_t panel, uint8_t *lut, size_t size) {
+  return ESP_OK;
+}
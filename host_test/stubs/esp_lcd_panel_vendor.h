@@ -0,0 +1,11 @@
+#pragma once
+
+#include "esp_lcd_panel_io.h"
+
+typedef struct {
+  int reset_gpio_num;
+  struct {
+    unsigned int reset_active_high : 1;
+  } flags;
+  void *vendor_config;
+} esp_lcd_panel_dev_config_t;
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <stdint.h>
+
+// Virtual time in microseconds, or the wall clock for benchmarks, see
+// host_rtos.hpp
+int64_t esp_timer_get_time(void);
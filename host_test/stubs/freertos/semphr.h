@@ -0,0 +1,14 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct HostSemaphore *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore,
+                          TickType_t ticks_to_wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore,
+                                 BaseType_t *woken);
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+typedef enum {
+  eNoAction,
+  eSetBits,
+  eIncrement,
+  eSetValueWithOverwrite,
+  eSetValueWithoutOverwrite,
+} eNotifyAction;
+
+BaseType_t xTaskCreate(TaskFunction_t entry, const char *name,
+                       uint32_t stack_depth, void *arg, UBaseType_t priority,
+                       TaskHandle_t *handle);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value,
+                       eNotifyAction action);
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value,
+                              eNotifyAction action, BaseType_t *woken);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait);
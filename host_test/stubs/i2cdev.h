@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+
+// The parts of the esp-idf-lib descriptor the sensor code touches
+
+typedef int i2c_port_t;
+typedef int gpio_num_t;
+
+typedef struct {
+  gpio_num_t sda_io_num;
+  gpio_num_t scl_io_num;
+  uint8_t sda_pullup_en;
+  uint8_t scl_pullup_en;
+  struct {
+    uint32_t clk_speed;
+  } master;
+} i2c_config_t;
+
+typedef struct {
+  i2c_port_t port;
+  i2c_config_t cfg;
+  uint8_t addr;
+} i2c_dev_t;
@@ -0,0 +1,4 @@
+#pragma once
+
+// No driver on the host, CONFIG_SCD4X_USE_SIMULATOR routes every scd4x_*
+// call to the simulator in main/scd4x_sim.cpp
@@ -0,0 +1,5 @@
+#pragma once
+
+// Host build configuration
+#define CONFIG_FREERTOS_HZ 100
+#define CONFIG_SCD4X_USE_SIMULATOR 1
@@ -0,0 +1,208 @@
+#include "data_bus.hpp"
+#include "esp_log.h"
+#include "host_rtos.hpp"
+#include "scd4x_manager.hpp"
+#include "scd4x_sim.hpp"
+#include <stdio.h>
+#include <string.h>
+
+// Drives Scd4xManager against the simulated sensor on a virtual clock and
+// checks the simulator counters
+
+#define HOUR_US (3600LL * 1000000LL)
+
+static int failures;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static void print_stats(const char *name, const Scd4xSimStats &stats) {
+  printf("%s: %lld s, %u transfers, %u nacks, bus %lld us, active %lld s, "
+         "%u samples, %u read, %u ready polls\n",
+         name, (long long)(stats.elapsed_us / 1000000), stats.transactions,
+         stats.nacks, (long long)stats.bus_busy_us,
+         (long long)(stats.active_us / 1000000), stats.samples,
+         stats.samples_read, stats.ready_polls);
+}
+
+static void count_sample(const DataSample &sample, void *ctx) {
+  (*(uint32_t *)ctx)++;
+}
+
+/**
+ * @brief Run a manager with a fixed sampling preference
+ * @param preference Sampling mode, fixed so the wall clock hour does not
+ * matter
+ * @param duration_us Virtual time to measure for
+ * @param stats Output, simulator counters from start() on
+ * @param published Output, CO2 samples published on the data bus
+ */
+static void run_manager(SamplingPreference preference, int64_t duration_us,
+                        Scd4xSimStats *stats, uint32_t *published) {
+  host_reset();
+  Scd4xManager manager;
+  CHECK(manager.init(1, 2) == ESP_OK);
+
+  *published = 0;
+  DataFilter filter = {DATA_TOPIC_BIT(TOPIC_CO2), 0, nullptr, nullptr};
+  int sub = data_bus.subscribeCallback(filter, count_sample, published);
+
+  CHECK(manager.setSamplingPreference(preference) == ESP_OK);
+  manager.start();
+  scd4x_sim_reset_stats();
+  host_run(duration_us);
+  scd4x_sim_get_stats(stats);
+  data_bus.unsubscribe(sub);
+}
+
+// Samples of a sensor with the simulated clock error over a time span
+static uint32_t expected_samples(int64_t duration_us, int64_t period_us) {
+  return (uint32_t)(duration_us /
+                    (period_us + period_us * SCD4X_SIM_CLOCK_PPM / 1000000));
+}
+
+static void test_fast() {
+  Scd4xSimStats stats;
+  uint32_t published;
+  run_manager(SAMPLING_FAST, HOUR_US, &stats, &published);
+  print_stats("fast", stats);
+
+  uint32_t expected = expected_samples(HOUR_US, 5000000);
+  CHECK(stats.samples >= expected - 1 && stats.samples <= expected + 1);
+  // Every sample is read and published, none is missed by the phase
+  // tracker
+  CHECK(stats.samples_read + 1 >= stats.samples);
+  CHECK(published == stats.samples_read);
+  // One scheduled check per sample plus the probes that follow the slow
+  // sensor clock, polling from the lead time would take about 20
+  CHECK(stats.ready_polls <= stats.samples_read * 3 / 2);
+  CHECK(stats.nacks == 0);
+}
+
+static void test_low_power() {
+  Scd4xSimStats stats;
+  uint32_t published;
+  run_manager(SAMPLING_LOW_POWER, HOUR_US, &stats, &published);
+  print_stats("low_power", stats);
+
+  uint32_t expected = expected_samples(HOUR_US, 30000000);
+  CHECK(stats.samples >= expected - 1 && stats.samples <= expected + 1);
+  CHECK(stats.samples_read + 1 >= stats.samples);
+  CHECK(published == stats.samples_read);
+  CHECK(stats.ready_polls <= stats.samples_read * 2);
+  CHECK(stats.nacks == 0);
+}
+
+static void test_single_shot() {
+  Scd4xSimStats stats;
+  uint32_t published;
+  run_manager(SAMPLING_SINGLE_SHOT, HOUR_US, &stats, &published);
+  print_stats("single_shot", stats);
+
+  // One 5 s shot every 5 min
+  CHECK(stats.samples >= 11 && stats.samples <= 13);
+  CHECK(stats.samples_read == stats.samples);
+  CHECK(published == stats.samples_read);
+  // The check at 5 s comes just before the skewed shot completes
+  CHECK(stats.ready_polls <= stats.samples_read * 2);
+  // The sensor only measures during the shots
+  CHECK(stats.active_us <= (int64_t)stats.samples * 5100000LL);
+  CHECK(stats.nacks == 0);
+}
+
+struct CommandLog {
+  int calls;
+  Scd4xResult result;
+};
+
+static void command_done(const Scd4xResult &result, void *ctx) {
+  CommandLog *log = (CommandLog *)ctx;
+  log->calls++;
+  log->result = result;
+}
+
+static void test_command_during_periodic() {
+  host_reset();
+  Scd4xManager manager;
+  CHECK(manager.init(1, 2) == ESP_OK);
+  CHECK(manager.setSamplingPreference(SAMPLING_FAST) == ESP_OK);
+  manager.start();
+  scd4x_sim_reset_stats();
+
+  // Toggle ASC from another task ten minutes in, then read it back from
+  // the cache
+  CommandLog toggle = {};
+  CommandLog status = {};
+  host_at(10 * 60 * 1000000LL, [&] {
+    CHECK(manager.toggleASC(command_done, &toggle) == ESP_OK);
+    CHECK(manager.getASCStatus(command_done, &status) == ESP_OK);
+  });
+
+  Scd4xSimStats before = {};
+  host_at(20 * 60 * 1000000LL, [&] { scd4x_sim_get_stats(&before); });
+  host_run(30 * 60 * 1000000LL);
+
+  Scd4xSimStats stats;
+  scd4x_sim_get_stats(&stats);
+  print_stats("command", stats);
+
+  CHECK(toggle.calls == 1);
+  CHECK(toggle.result.type == SCD4X_CMD_TOGGLE_ASC);
+  CHECK(toggle.result.err == ESP_OK);
+  CHECK(!toggle.result.asc_enabled); // The simulator starts with ASC on
+  CHECK(status.calls == 1);
+  CHECK(status.result.err == ESP_OK);
+  CHECK(!status.result.asc_enabled);
+  // Measurement stopped for the command and came back
+  CHECK(stats.nacks == 0);
+  CHECK(manager.getMode() == SCD4X_MODE_PERIODIC);
+  CHECK(stats.samples_read - before.samples_read >=
+        expected_samples(10 * 60 * 1000000LL, 5000000) - 1);
+}
+
+static void test_deterministic() {
+  Scd4xSimStats first, second;
+  uint32_t published;
+  run_manager(SAMPLING_FAST, HOUR_US / 4, &first, &published);
+  run_manager(SAMPLING_FAST, HOUR_US / 4, &second, &published);
+  CHECK(memcmp(&first, &second, sizeof(first)) == 0);
+}
+
+struct TestCase {
+  const char *name;
+  void (*run)();
+};
+
+static const TestCase tests[] = {
+    {"fast", test_fast},
+    {"low_power", test_low_power},
+    {"single_shot", test_single_shot},
+    {"command_during_periodic", test_command_during_periodic},
+    {"deterministic", test_deterministic},
+};
+
+// Runs the named test, or all of them without an argument
+int main(int argc, char **argv) {
+  esp_log_level_set("*", ESP_LOG_ERROR);
+  int ran = 0;
+  for (const TestCase &test : tests) {
+    if (argc > 1 && strcmp(argv[1], test.name) != 0) {
+      continue;
+    }
+    printf("[%s]\n", test.name);
+    test.run();
+    ran++;
+  }
+  host_reset();
+  if (ran == 0) {
+    printf("No test named %s\n", argv[1]);
+    return 1;
+  }
+  printf("%d failure(s)\n", failures);
+  return failures ? 1 : 0;
+}
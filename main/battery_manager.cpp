@@ -1,5 +1,6 @@
 #include "battery_manager.hpp"
 #include "common_data.hpp"
+#include "data_bus.hpp"
 #include "esp_adc/adc_cali_scheme.h"
 #include "esp_log.h"
 
@@ -120,9 +121,8 @@ void BatteryManager::battery_task(void *pvParameters) {
     float battery_v = (voltage_mv * 2.0f) / 1000.0f;
 
     // Update shared state
-    DeviceStatus status = global_data.getStatus();
-    status.battery_voltage = battery_v;
-    global_data.setStatus(status);
+    global_data.setBatteryVoltage(battery_v);
+    data_bus.publish(TOPIC_BATTERY, battery_v);
 
     ESP_LOGD(TAG, "Battery: Raw %d, %d mV, %.2f V", adc_raw, voltage_mv,
              battery_v);
@@ -0,0 +1,204 @@
+#include "book_bench.hpp"
+#include "Fonts/FreeSans7pt7b.h"
+#include "book_reader.hpp"
+#include "book_source.hpp"
+#include "book_store.hpp"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <string>
+
+static const char *TAG = "BookBench";
+
+// Steps per source
+#define BOOK_BENCH_OPENS 20
+#define BOOK_BENCH_TURNS 200
+// Give up on a pagination that does not finish
+#define BOOK_BENCH_PAGINATE_TIMEOUT_US (120 * 1000000LL)
+
+// Reader layout, see ui_manager.cpp
+#define BOOK_BENCH_MAX_LINES 7
+#define BOOK_BENCH_LINE_WIDTH 296
+
+#define BOOK_BENCH_NAME "book.bkz"
+// Scratch files, removed afterwards
+#define BOOK_BENCH_TEXT_PATH "/littlefs/bench.txt"
+#define BOOK_BENCH_INDEX_PATH "/littlefs/bench" BOOK_INDEX_SUFFIX
+
+/**
+ * @brief Times and peak heap use of one kind of step
+ */
+struct BenchStat {
+  int64_t total_us;
+  int64_t max_us;
+  uint32_t count;
+  size_t peak_heap; // Most heap in use above the start of a step
+};
+
+typedef BookSource *(*SourceFactory)(BookStore *store);
+
+// Reset the heap low watermark, returns the free heap to measure against
+static size_t heapWatchStart() {
+  size_t free_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  heap_caps_monitor_local_minimum_free_size_start();
+  return free_before;
+}
+
+// Heap used at the low point since heapWatchStart
+static size_t heapWatchStop(size_t free_before) {
+  size_t lowest = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+  heap_caps_monitor_local_minimum_free_size_stop();
+  return (lowest < free_before) ? free_before - lowest : 0;
+}
+
+static void record(BenchStat &stat, int64_t us, size_t heap) {
+  stat.total_us += us;
+  stat.count++;
+  if (us > stat.max_us) {
+    stat.max_us = us;
+  }
+  if (heap > stat.peak_heap) {
+    stat.peak_heap = heap;
+  }
+}
+
+static void report(const char *source, const char *step,
+                   const BenchStat &stat) {
+  if (stat.count == 0) {
+    return;
+  }
+  ESP_LOGI(TAG, "%-10s %-8s avg %7lld us, max %7lld us, peak heap %6u B",
+           source, step, stat.total_us / stat.count, stat.max_us,
+           (unsigned)stat.peak_heap);
+}
+
+static BookSource *openFile(BookStore *store) {
+  FileBookSource *source = new FileBookSource(BOOK_BENCH_TEXT_PATH);
+  if (!source->valid()) {
+    delete source;
+    return nullptr;
+  }
+  return source;
+}
+
+static BookSource *openMapped(BookStore *store) {
+  return store->open(BOOK_BENCH_NAME);
+}
+
+// The build puts the book into the book partition only, the plain file path
+// is measured on a copy of the text on LittleFS
+static bool writeText(BookSource *source, const char *path) {
+  BookStream *stream = source->stream();
+  FILE *f = fopen(path, "wb");
+  bool ok = stream && f;
+  uint32_t offset = 0;
+  while (ok && offset < source->size()) {
+    std::string_view chunk = stream->read(offset, BOOK_CHUNK_SIZE);
+    ok = !chunk.empty() &&
+         fwrite(chunk.data(), 1, chunk.size(), f) == chunk.size();
+    offset += chunk.size();
+  }
+  if (f) {
+    fclose(f);
+  }
+  delete stream;
+  if (!ok) {
+    remove(path);
+  }
+  return ok;
+}
+
+static void benchSource(const char *name, SourceFactory create,
+                        BookStore *store) {
+  BookSource *probe = create(store);
+  if (probe == nullptr) {
+    ESP_LOGW(TAG, "%s: book not found, skipped", name);
+    return;
+  }
+  delete probe;
+  remove(BOOK_BENCH_INDEX_PATH);
+  BookReader reader(&FreeSans7pt7b, BOOK_BENCH_MAX_LINES,
+                    BOOK_BENCH_LINE_WIDTH);
+
+  // Without an index the first open paginates in the background, closing
+  // waits for the index to be written
+  BenchStat paginate = {};
+  size_t before = heapWatchStart();
+  int64_t start = esp_timer_get_time();
+  if (reader.open(create(store), BOOK_BENCH_INDEX_PATH) != ESP_OK) {
+    heapWatchStop(before);
+    ESP_LOGE(TAG, "%s: open failed", name);
+    return;
+  }
+  while (!reader.isComplete() &&
+         esp_timer_get_time() - start < BOOK_BENCH_PAGINATE_TIMEOUT_US) {
+    vTaskDelay(1);
+  }
+  bool complete = reader.isComplete();
+  reader.close();
+  record(paginate, esp_timer_get_time() - start, heapWatchStop(before));
+  if (!complete) {
+    ESP_LOGE(TAG, "%s: pagination did not finish", name);
+    return;
+  }
+
+  // Opens load the stored index
+  BenchStat open = {};
+  for (int i = 0; i < BOOK_BENCH_OPENS; i++) {
+    before = heapWatchStart();
+    start = esp_timer_get_time();
+    esp_err_t err = reader.open(create(store), BOOK_BENCH_INDEX_PATH);
+    record(open, esp_timer_get_time() - start, heapWatchStop(before));
+    if (err != ESP_OK || !reader.isComplete()) {
+      ESP_LOGE(TAG, "%s: stored index not used", name);
+      break;
+    }
+    reader.close();
+  }
+
+  // Page forward through the book, wrapping at the end
+  BenchStat turn = {};
+  std::string text;
+  if (reader.isOpen() ||
+      reader.open(create(store), BOOK_BENCH_INDEX_PATH) == ESP_OK) {
+    uint32_t offset = 0;
+    for (int i = 0; i < BOOK_BENCH_TURNS; i++) {
+      uint32_t next = 0;
+      before = heapWatchStart();
+      start = esp_timer_get_time();
+      esp_err_t err = reader.readPage(offset, text, &next);
+      record(turn, esp_timer_get_time() - start, heapWatchStop(before));
+      if (err != ESP_OK) {
+        ESP_LOGE(TAG, "%s: page read failed at %lu", name, offset);
+        break;
+      }
+      offset = (next < reader.getFileSize()) ? next : 0;
+    }
+  }
+  reader.close();
+  remove(BOOK_BENCH_INDEX_PATH);
+
+  report(name, "paginate", paginate);
+  report(name, "open", open);
+  report(name, "page", turn);
+}
+
+void book_benchmark() {
+  BookStore store;
+  store.mount();
+
+  BookSource *text = openMapped(&store);
+  if (text) {
+    ESP_LOGI(TAG, "Book of %lu bytes, %d opens and %d page turns per source",
+             text->size(), BOOK_BENCH_OPENS, BOOK_BENCH_TURNS);
+    writeText(text, BOOK_BENCH_TEXT_PATH);
+    delete text;
+  }
+
+  benchSource("file", openFile, &store);
+  benchSource("mapped bkz", openMapped, &store);
+  remove(BOOK_BENCH_TEXT_PATH);
+}
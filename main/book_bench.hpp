@@ -0,0 +1,15 @@
+#pragma once
+
+// Run the book source benchmark at startup, before the UI opens the book
+#define BOOK_RUN_BENCHMARK 0
+
+/**
+ * @brief Compare the book sources on pagination, open and page turns
+ *
+ * Each source paginates the book once into a scratch index, is opened
+ * BOOK_BENCH_OPENS times from that index and then turns BOOK_BENCH_TURNS
+ * pages. Average and worst times and the peak heap use of every step are
+ * logged. The peak is taken from the heap low watermark, reset before each
+ * step. Needs LittleFS mounted and nothing else allocating meanwhile.
+ */
+void book_benchmark();
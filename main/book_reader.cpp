@@ -0,0 +1,602 @@
+#include "book_reader.hpp"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include <algorithm>
+#include <stdio.h>
+
+static const char *TAG = "BookReader";
+
+// "BIDX", bump the low byte when the page layout rules change
+#define BOOK_INDEX_MAGIC 0x42494401
+
+PageBreaker::PageBreaker(const GFXfont *font, int max_lines, int max_width)
+    : font(font), max_lines(max_lines), max_width(max_width), space_width(0),
+      layout_hash(2166136261u), full_page_bytes(0), text(nullptr),
+      in_word(false), word_start(0), word_width(0), newlines(0),
+      page_empty(true), lines(0), line_width(0) {
+  space_width = charWidth(' ');
+
+  // FNV-1a over everything that affects where pages break
+  int32_t params[] = {max_lines, max_width, font->first, font->last,
+                      font->yAdvance};
+  const uint8_t *bytes = (const uint8_t *)params;
+  for (size_t i = 0; i < sizeof(params); i++) {
+    layout_hash = (layout_hash ^ bytes[i]) * 16777619u;
+  }
+  uint32_t advance_sum = 0;
+  for (uint16_t c = font->first; c <= font->last; c++) {
+    uint8_t advance = font->glyph[c - font->first].xAdvance;
+    layout_hash = (layout_hash ^ advance) * 16777619u;
+    advance_sum += advance;
+  }
+
+  uint32_t glyphs = font->last - font->first + 1;
+  full_page_bytes = (advance_sum > 0)
+                        ? (uint32_t)max_lines * max_width * glyphs / advance_sum
+                        : 1;
+}
+
+int PageBreaker::charWidth(char c) const {
+  uint8_t code = (uint8_t)c;
+  if (code < font->first || code > font->last) {
+    return 0;
+  }
+  return font->glyph[code - font->first].xAdvance;
+}
+
+void PageBreaker::reset(std::string *out) {
+  text = out;
+  word.clear();
+  in_word = false;
+  word_width = 0;
+  newlines = 0;
+  page_empty = true;
+  lines = 0;
+  line_width = 0;
+  completed.clear();
+}
+
+void PageBreaker::feed(const char *data, size_t len, uint32_t offset) {
+  for (size_t i = 0; i < len; i++) {
+    char c = data[i];
+    if (c == ' ' || c == '\n' || c == '\r') {
+      if (in_word) {
+        endWord();
+      }
+      if (c == '\n') {
+        newlines++;
+      }
+      continue;
+    }
+
+    if (!in_word) {
+      in_word = true;
+      word_start = offset + i;
+      word.clear();
+      word_width = 0;
+    }
+    word += c;
+    word_width += charWidth(c);
+  }
+}
+
+void PageBreaker::finish() {
+  if (in_word) {
+    endWord();
+  }
+}
+
+bool PageBreaker::nextPage(uint32_t &offset) {
+  if (completed.empty()) {
+    return false;
+  }
+  offset = completed.front();
+  completed.erase(completed.begin());
+  return true;
+}
+
+void PageBreaker::breakPage() {
+  completed.push_back(word_start);
+  // Only a single page is collected, the rest belongs to the next one
+  text = nullptr;
+  page_empty = true;
+  lines = 0;
+  line_width = 0;
+}
+
+void PageBreaker::endWord() {
+  in_word = false;
+
+  if (page_empty) {
+    // Whitespace at the top of a page is dropped
+  } else if (newlines >= 2) {
+    // Paragraph break, leaves a blank line
+    int cost = (line_width > 0) ? 2 : 1;
+    if (lines + cost >= max_lines) {
+      breakPage();
+    } else {
+      if (text) {
+        *text += (line_width > 0) ? "\n\n" : "\n";
+      }
+      lines += cost;
+      line_width = 0;
+    }
+  } else if (line_width + space_width + word_width > max_width) {
+    // Wrap to the next line
+    if (lines + 1 >= max_lines) {
+      breakPage();
+    } else {
+      if (text) {
+        *text += '\n';
+      }
+      lines++;
+      line_width = 0;
+    }
+  } else {
+    if (text) {
+      *text += ' ';
+    }
+    line_width += space_width;
+  }
+
+  if (text) {
+    *text += word;
+  }
+  line_width += word_width;
+  page_empty = false;
+  newlines = 0;
+}
+
+BookReader::BookReader(const GFXfont *font, int max_lines, int max_width)
+    : breaker(font, max_lines, max_width),
+      page_breaker(font, max_lines, max_width), source(nullptr),
+      page_stream(nullptr), file_size(0), mtime(0),
+      resume(0), head_scanned(0), tail_scanned(0), complete(false),
+      task(nullptr), cancel(false), ready(nullptr),
+      ready_ctx(nullptr) {
+  lock = xSemaphoreCreateMutex();
+}
+
+BookReader::~BookReader() {
+  close();
+  vSemaphoreDelete(lock);
+}
+
+esp_err_t BookReader::open(BookSource *book, const char *index,
+                           uint32_t resume_offset, BookReadyCallback ready_cb,
+                           void *ctx) {
+  close();
+  if (book->size() == 0) {
+    delete book;
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  int64_t start = esp_timer_get_time();
+  page_stream = book->stream();
+  if (page_stream == nullptr) {
+    delete book;
+    return ESP_FAIL;
+  }
+  source = book;
+  index_path = index;
+  file_size = book->size();
+  mtime = book->version();
+  resume = (resume_offset < file_size) ? resume_offset : 0;
+  ready = ready_cb;
+  ready_ctx = ctx;
+
+  if (loadIndex()) {
+    complete = true;
+    // Resume at the start of the page holding the saved offset
+    resume = *(std::upper_bound(offsets.begin(), offsets.end(), resume) - 1);
+    // The lowest free heap since boot shows peaks the current value misses,
+    // book_bench.cpp measures them per step
+    ESP_LOGI(TAG,
+             "Opened %s book with %u pages in %lld us, free heap %lu, "
+             "lowest %lu",
+             source->kind(), (unsigned)offsets.size(),
+             esp_timer_get_time() - start, esp_get_free_heap_size(),
+             esp_get_minimum_free_heap_size());
+    return ESP_OK;
+  }
+
+  // Paginate in the background, the reader can show pages meanwhile
+  cancel = false;
+  if (xTaskCreate(taskEntry, "book_index", BOOK_TASK_STACK, this,
+                  BOOK_TASK_PRIORITY, &task) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to start pagination task");
+    task = nullptr;
+    close();
+    return ESP_ERR_NO_MEM;
+  }
+  ESP_LOGI(TAG, "Opened %s book in %lld us, paginating from offset %lu",
+           source->kind(), esp_timer_get_time() - start, resume);
+  return ESP_OK;
+}
+
+void BookReader::stop() {
+  if (task == nullptr) {
+    return;
+  }
+  // The task checks the flag between chunks and clears the handle on exit
+  cancel = true;
+  while (task != nullptr) {
+    vTaskDelay(1);
+  }
+  cancel = false;
+}
+
+void BookReader::close() {
+  stop();
+  delete page_stream;
+  page_stream = nullptr;
+  delete source;
+  source = nullptr;
+
+  xSemaphoreTake(lock, portMAX_DELAY);
+  index_path.clear();
+  offsets.clear();
+  offsets.shrink_to_fit();
+  tail.clear();
+  tail.shrink_to_fit();
+  head_scanned = 0;
+  tail_scanned = 0;
+  complete = false;
+  file_size = 0;
+  mtime = 0;
+  resume = 0;
+  xSemaphoreGive(lock);
+}
+
+bool BookReader::loadIndex() {
+  FILE *f = fopen(index_path.c_str(), "rb");
+  if (f == NULL) {
+    return false;
+  }
+
+  BookIndexHeader header;
+  bool valid = fread(&header, sizeof(header), 1, f) == 1 &&
+               header.magic == BOOK_INDEX_MAGIC &&
+               header.file_size == file_size && header.mtime == mtime &&
+               header.layout_hash == breaker.getLayoutHash() &&
+               header.page_count > 0 && header.page_count <= file_size;
+  if (valid) {
+    offsets.resize(header.page_count);
+    valid = fread(offsets.data(), sizeof(uint32_t), offsets.size(), f) ==
+            offsets.size();
+  }
+  fclose(f);
+
+  // Offsets have to start at the top and increase within the file
+  for (size_t i = 0; valid && i < offsets.size(); i++) {
+    valid = (i == 0) ? offsets[0] == 0
+                     : offsets[i] > offsets[i - 1] && offsets[i] < file_size;
+  }
+
+  if (!valid) {
+    ESP_LOGI(TAG, "Index %s is stale", index_path.c_str());
+    offsets.clear();
+  }
+  return valid;
+}
+
+void BookReader::saveIndex() {
+  FILE *f = fopen(index_path.c_str(), "wb");
+  if (f == NULL) {
+    ESP_LOGW(TAG, "Failed to create %s", index_path.c_str());
+    return;
+  }
+
+  BookIndexHeader header = {
+      .magic = BOOK_INDEX_MAGIC,
+      .file_size = file_size,
+      .mtime = mtime,
+      .layout_hash = breaker.getLayoutHash(),
+      .page_count = (uint32_t)offsets.size(),
+  };
+  bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+            fwrite(offsets.data(), sizeof(uint32_t), offsets.size(), f) ==
+                offsets.size();
+  fclose(f);
+
+  if (!ok) {
+    // A partial index would be rejected anyway, don't keep it around
+    ESP_LOGW(TAG, "Failed to write %s", index_path.c_str());
+    remove(index_path.c_str());
+  }
+}
+
+void BookReader::taskEntry(void *param) {
+  BookReader *self = (BookReader *)param;
+  int64_t start = esp_timer_get_time();
+
+  bool done = false;
+  BookStream *stream = self->source->stream();
+  if (stream) {
+    done = self->paginateTail(stream) && self->paginateHead(stream);
+    delete stream;
+  }
+
+  if (done) {
+    ESP_LOGI(TAG, "Paginated %lu bytes into %u pages in %lld us",
+             self->file_size, (unsigned)self->offsets.size(),
+             esp_timer_get_time() - start);
+    self->saveIndex();
+    if (self->ready) {
+      self->ready(self->ready_ctx);
+    }
+  }
+
+  xSemaphoreTake(self->lock, portMAX_DELAY);
+  self->task = nullptr;
+  xSemaphoreGive(self->lock);
+  vTaskDelete(NULL);
+}
+
+bool BookReader::paginateTail(BookStream *stream) {
+  if (resume == 0) {
+    // The head pass covers the whole book
+    return true;
+  }
+
+  xSemaphoreTake(lock, portMAX_DELAY);
+  tail.push_back(resume);
+  tail_scanned = resume;
+  xSemaphoreGive(lock);
+
+  uint32_t offset = resume;
+  uint32_t page;
+  breaker.reset();
+
+  while (!cancel && offset < file_size) {
+    std::string_view chunk = stream->read(offset, BOOK_CHUNK_SIZE);
+    if (chunk.empty()) {
+      ESP_LOGE(TAG, "Read error at %lu", offset);
+      return false;
+    }
+    breaker.feed(chunk.data(), chunk.size(), offset);
+    offset += chunk.size();
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    while (breaker.nextPage(page)) {
+      tail.push_back(page);
+    }
+    tail_scanned = offset;
+    xSemaphoreGive(lock);
+
+    // Let the idle task run, this task would starve it otherwise
+    vTaskDelay(1);
+  }
+  if (cancel) {
+    return false;
+  }
+
+  breaker.finish();
+  xSemaphoreTake(lock, portMAX_DELAY);
+  while (breaker.nextPage(page)) {
+    tail.push_back(page);
+  }
+  xSemaphoreGive(lock);
+  return true;
+}
+
+bool BookReader::addHeadPage(uint32_t page) {
+  if (!tail.empty() && page >= tail.front()) {
+    if (page == tail.front()) {
+      // Reached the resume position, the tail continues from here
+      offsets.insert(offsets.end(), tail.begin(), tail.end());
+      tail.clear();
+      return true;
+    }
+    // The resume offset was no page start with this layout, so the tail
+    // pages are off. Paginate the rest from the head.
+    ESP_LOGW(TAG, "Resume offset %lu is not a page start", tail.front());
+    tail.clear();
+  }
+  offsets.push_back(page);
+  return false;
+}
+
+bool BookReader::paginateHead(BookStream *stream) {
+  xSemaphoreTake(lock, portMAX_DELAY);
+  offsets.push_back(0);
+  xSemaphoreGive(lock);
+
+  uint32_t offset = 0;
+  uint32_t page;
+  bool merged = false;
+  breaker.reset();
+
+  while (!cancel && !merged && offset < file_size) {
+    std::string_view chunk = stream->read(offset, BOOK_CHUNK_SIZE);
+    if (chunk.empty()) {
+      ESP_LOGE(TAG, "Read error at %lu", offset);
+      return false;
+    }
+    breaker.feed(chunk.data(), chunk.size(), offset);
+    offset += chunk.size();
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    while (!merged && breaker.nextPage(page)) {
+      merged = addHeadPage(page);
+    }
+    head_scanned = offset;
+    complete = merged;
+    xSemaphoreGive(lock);
+
+    vTaskDelay(1);
+  }
+  if (merged) {
+    return true;
+  }
+  if (cancel) {
+    return false;
+  }
+
+  breaker.finish();
+  xSemaphoreTake(lock, portMAX_DELAY);
+  while (!merged && breaker.nextPage(page)) {
+    merged = addHeadPage(page);
+  }
+  // Whatever is left of a misaligned tail is covered by the head now
+  tail.clear();
+  complete = true;
+  xSemaphoreGive(lock);
+  return true;
+}
+
+esp_err_t BookReader::readPage(uint32_t offset, std::string &text,
+                               uint32_t *next) {
+  text.clear();
+  if (offset >= file_size) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Lay out words until the next page starts, a page usually fits in the
+  // first chunk
+  int64_t start = esp_timer_get_time();
+  uint32_t pos = offset;
+  uint32_t end = file_size;
+  bool found = false;
+  page_breaker.reset(&text);
+  while (!found && pos < file_size) {
+    std::string_view chunk = page_stream->read(pos, BOOK_CHUNK_SIZE);
+    if (chunk.empty()) {
+      ESP_LOGE(TAG, "Read error at %lu", pos);
+      return ESP_FAIL;
+    }
+    page_breaker.feed(chunk.data(), chunk.size(), pos);
+    pos += chunk.size();
+    found = page_breaker.nextPage(end);
+  }
+  if (!found) {
+    page_breaker.finish();
+  }
+
+  ESP_LOGD(TAG,
+           "Page at %lu from %s book in %lld us, free heap %lu, lowest %lu",
+           offset, source->kind(), esp_timer_get_time() - start,
+           esp_get_free_heap_size(), esp_get_minimum_free_heap_size());
+  if (next) {
+    *next = end;
+  }
+  return ESP_OK;
+}
+
+bool BookReader::nextPage(uint32_t offset, uint32_t &next) {
+  bool found = false;
+  xSemaphoreTake(lock, portMAX_DELAY);
+  // Both tables hold consecutive pages, the first start above offset is
+  // the next page if there is one
+  if (!tail.empty() && offset >= tail.front()) {
+    auto it = std::upper_bound(tail.begin(), tail.end(), offset);
+    if (it != tail.end()) {
+      next = *it;
+      found = true;
+    }
+  } else {
+    auto it = std::upper_bound(offsets.begin(), offsets.end(), offset);
+    if (it != offsets.end()) {
+      next = *it;
+      found = true;
+    }
+  }
+  bool at_end = complete && !found;
+  xSemaphoreGive(lock);
+
+  if (found) {
+    return true;
+  }
+  if (at_end) {
+    return false;
+  }
+
+  // Not paginated yet, lay the page out to find its end
+  std::string text;
+  if (readPage(offset, text, &next) != ESP_OK) {
+    return false;
+  }
+  return next < file_size;
+}
+
+bool BookReader::previousPage(uint32_t offset, uint32_t &prev) {
+  bool found = false;
+  xSemaphoreTake(lock, portMAX_DELAY);
+  if (!tail.empty() && offset > tail.front()) {
+    auto it = std::lower_bound(tail.begin(), tail.end(), offset);
+    prev = *(it - 1);
+    found = true;
+  } else {
+    // Only valid once the head pass got past offset
+    auto it = std::lower_bound(offsets.begin(), offsets.end(), offset);
+    if (it != offsets.begin() && (it != offsets.end() || complete)) {
+      prev = *(it - 1);
+      found = true;
+    }
+  }
+  xSemaphoreGive(lock);
+  return found;
+}
+
+bool BookReader::getPageOffset(uint32_t page, uint32_t &offset) {
+  bool found = false;
+  xSemaphoreTake(lock, portMAX_DELAY);
+  // The head pass fills offsets from the first page on
+  if (page < offsets.size()) {
+    offset = offsets[page];
+    found = true;
+  } else if (complete && !offsets.empty()) {
+    offset = offsets.back();
+    found = true;
+  }
+  xSemaphoreGive(lock);
+  return found;
+}
+
+void BookReader::getPosition(uint32_t offset, BookPosition &pos) {
+  xSemaphoreTake(lock, portMAX_DELAY);
+  auto it = std::upper_bound(offsets.begin(), offsets.end(), offset);
+  pos.page = it - offsets.begin();
+  pos.pages = offsets.size();
+  // Exact once the head pass got to offset
+  pos.page_exact = complete || it != offsets.end() ||
+                   (pos.page > 0 && offsets[pos.page - 1] == offset);
+  pos.pages_exact = complete;
+
+  if (!complete) {
+    // Estimate from the average page length seen so far, or from the
+    // layout before the first chunk is done
+    uint32_t known = offsets.size() + tail.size();
+    uint32_t covered = head_scanned;
+    if (!tail.empty()) {
+      covered += tail_scanned - tail.front();
+    }
+    uint32_t average = (covered > 0 && known > 0)
+                           ? covered / known
+                           : breaker.getFullPageBytes();
+    if (average == 0) {
+      average = 1;
+    }
+
+    // Pages between the head pass and offset are guessed
+    bool in_tail = !tail.empty() && offset >= tail.front();
+    uint32_t from = in_tail ? tail.front() : offset;
+    uint32_t gap = (from > head_scanned) ? (from - head_scanned) / average : 0;
+    if (in_tail) {
+      pos.page = offsets.size() + gap +
+                 (std::upper_bound(tail.begin(), tail.end(), offset) -
+                  tail.begin());
+    } else if (!pos.page_exact) {
+      pos.page = offsets.size() + gap;
+    }
+    pos.pages = known + (file_size - covered) / average;
+    if (pos.page < 1) {
+      pos.page = 1;
+    }
+    if (pos.pages < pos.page) {
+      pos.pages = pos.page;
+    }
+  }
+  xSemaphoreGive(lock);
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include "book_source.hpp"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "gfxfont.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Bytes read from the book at a time while paginating
+#define BOOK_CHUNK_SIZE 1024
+// Suffix of the page index stored next to a book
+#define BOOK_INDEX_SUFFIX ".idx"
+// Stack and priority of the background pagination task
+#define BOOK_TASK_STACK 3072
+#define BOOK_TASK_PRIORITY 1
+
+/**
+ * @brief Streaming word wrapper that splits text into pages
+ *
+ * Text is fed in chunks of any size. Words are wrapped to the line width,
+ * single newlines join lines and blank lines start a paragraph. The breaker
+ * reports the byte offset of the first word of every page after the first,
+ * and can optionally collect the laid out text of the page being fed.
+ */
+class PageBreaker {
+public:
+  PageBreaker(const GFXfont *font, int max_lines, int max_width);
+
+  /**
+   * @brief Start a new page
+   * @param text Receives the laid out page text, may be nullptr
+   */
+  void reset(std::string *text = nullptr);
+
+  /**
+   * @brief Feed the next chunk of text
+   * @param data Chunk bytes
+   * @param len Chunk length
+   * @param offset File offset of data[0]
+   */
+  void feed(const char *data, size_t len, uint32_t offset);
+
+  // End of input, lays out a word cut off by the end of the text
+  void finish();
+
+  /**
+   * @brief Get the start of a page completed by the last feed or finish
+   * @param offset Output, file offset of the first word of the next page
+   * @return true if a page was completed since the last call
+   */
+  bool nextPage(uint32_t &offset);
+
+  // Hash of the font metrics and geometry, changes whenever pages would
+  uint32_t getLayoutHash() const { return layout_hash; }
+
+  // Bytes a full page of average width characters takes
+  uint32_t getFullPageBytes() const { return full_page_bytes; }
+
+private:
+  const GFXfont *font;
+  int max_lines;
+  int max_width;
+  int space_width;
+  uint32_t layout_hash;
+  uint32_t full_page_bytes;
+
+  std::string *text;
+  std::string word;
+  bool in_word;
+  uint32_t word_start;
+  int word_width;
+  int newlines;
+
+  bool page_empty;
+  int lines;
+  int line_width;
+
+  // Pages completed but not collected with nextPage yet
+  std::vector<uint32_t> completed;
+
+  int charWidth(char c) const;
+  void endWord();
+  void breakPage();
+};
+
+/**
+ * @brief Header of the persisted page index
+ *
+ * The index is valid for one version of the book, identified by size and
+ * modification time, and for one layout. It is followed by page_count
+ * uint32 page start offsets.
+ */
+struct BookIndexHeader {
+  uint32_t magic;
+  uint32_t file_size;
+  int64_t mtime;
+  uint32_t layout_hash;
+  uint32_t page_count;
+};
+
+/**
+ * @brief Reading position within a book, see BookReader::getPosition
+ */
+struct BookPosition {
+  uint32_t page;     // 1-based page number
+  uint32_t pages;    // Page count
+  bool page_exact;   // False while page is an estimate
+  bool pages_exact;  // False while pages is an estimate
+};
+
+// Called on the pagination task once the page index is complete
+typedef void (*BookReadyCallback)(void *ctx);
+
+/**
+ * @brief Opens a text book and reads it one page at a time
+ *
+ * Pages are addressed by the byte offset of their first word, so a page
+ * can be shown before the book has been paginated. Only a table of page
+ * start offsets is kept in RAM. It is stored next to the book, so opening
+ * it again costs one index read.
+ *
+ * Without a stored index a low priority task paginates the book, first
+ * from the resume position to the end, then from the start up to the
+ * resume position. Until it is done page numbers are estimates.
+ */
+class BookReader {
+public:
+  BookReader(const GFXfont *font, int max_lines, int max_width);
+  ~BookReader();
+
+  /**
+   * @brief Open a book, loading its page index or starting to build it
+   * @param source Text of the book, owned by the reader from now on
+   * @param index_path Where the page index is kept
+   * @param resume Offset of the page to resume at, snapped to the start of
+   * the page containing it when the index is known
+   * @param ready Called when the index is complete, may be nullptr
+   * @param ctx Passed to ready
+   * @return ESP_OK, ESP_ERR_NOT_FOUND if the book is empty
+   */
+  esp_err_t open(BookSource *source, const char *index_path,
+                 uint32_t resume = 0, BookReadyCallback ready = nullptr,
+                 void *ctx = nullptr);
+
+  // Forget the open book, stops pagination
+  void close();
+
+  bool isOpen() const { return file_size > 0; }
+  bool isComplete() const { return complete; }
+  uint32_t getFileSize() const { return file_size; }
+
+  // Offset to resume at, adjusted by open
+  uint32_t getResumeOffset() const { return resume; }
+
+  /**
+   * @brief Read and lay out one page
+   * @param offset Page start offset
+   * @param text Output, page text with line breaks inserted
+   * @param next Output, start of the following page or the file size at the
+   * end, may be nullptr
+   * @return ESP_OK, ESP_ERR_INVALID_ARG for an offset past the end, ESP_FAIL
+   * on read errors
+   */
+  esp_err_t readPage(uint32_t offset, std::string &text,
+                     uint32_t *next = nullptr);
+
+  /**
+   * @brief Find the page after a page
+   * @return false at the end of the book
+   */
+  bool nextPage(uint32_t offset, uint32_t &next);
+
+  /**
+   * @brief Find the page before a page
+   * @return false on the first page, or while pagination has not got there
+   */
+  bool previousPage(uint32_t offset, uint32_t &prev);
+
+  // Page number and count for a page, estimated while paginating
+  void getPosition(uint32_t offset, BookPosition &pos);
+
+  /**
+   * @brief Find a page by its number
+   * @param page 0-based page number, past the end of the book gives the last
+   * page
+   * @param offset Output, page start offset
+   * @return false while pagination has not got there
+   */
+  bool getPageOffset(uint32_t page, uint32_t &offset);
+
+private:
+  PageBreaker breaker;      // Used by the pagination task
+  PageBreaker page_breaker; // Used to lay out pages for the reader
+  SemaphoreHandle_t lock;   // Guards the tables below
+
+  BookSource *source;
+  BookStream *page_stream; // Reads pages for the reader
+  std::string index_path;
+  uint32_t file_size;
+  int64_t mtime;
+  uint32_t resume;
+
+  // Page starts from the beginning of the book, all of them once complete
+  std::vector<uint32_t> offsets;
+  // Page starts from the resume offset, merged into offsets when complete
+  std::vector<uint32_t> tail;
+  // Bytes paginated into offsets and tail so far
+  uint32_t head_scanned;
+  uint32_t tail_scanned;
+  volatile bool complete;
+
+  TaskHandle_t task;
+  volatile bool cancel;
+  BookReadyCallback ready;
+  void *ready_ctx;
+
+  bool loadIndex();
+  void saveIndex();
+
+  // Pagination task
+  static void taskEntry(void *param);
+  bool paginateTail(BookStream *stream);
+  bool paginateHead(BookStream *stream);
+  bool addHeadPage(uint32_t page);
+  void stop();
+};
@@ -0,0 +1,263 @@
+#include "book_source.hpp"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "rom/miniz.h"
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+static const char *TAG = "BookSource";
+
+// Bytes buffered per read from a file
+#define FILE_STREAM_BUFFER 1024
+
+// Buffered reads through the VFS
+class FileBookStream : public BookStream {
+public:
+  FileBookStream(FILE *f) : f(f), position(0), buffer(FILE_STREAM_BUFFER) {}
+  ~FileBookStream() { fclose(f); }
+
+  std::string_view read(uint32_t offset, size_t len) {
+    // Sequential reads need no seek
+    if (offset != position) {
+      if (fseek(f, offset, SEEK_SET) != 0) {
+        ESP_LOGE(TAG, "Seek to %lu failed", offset);
+        return std::string_view();
+      }
+      position = offset;
+    }
+    if (len > buffer.size()) {
+      len = buffer.size();
+    }
+    size_t got = fread(buffer.data(), 1, len, f);
+    position += got;
+    return std::string_view(buffer.data(), got);
+  }
+
+private:
+  FILE *f;
+  uint32_t position;
+  std::vector<char> buffer;
+};
+
+// Views straight into the book memory
+class MemoryBookStream : public BookStream {
+public:
+  MemoryBookStream(const char *data, uint32_t size) : data(data), size(size) {}
+
+  std::string_view read(uint32_t offset, size_t len) {
+    if (offset >= size) {
+      return std::string_view();
+    }
+    if (len > size - offset) {
+      len = size - offset;
+    }
+    return std::string_view(data + offset, len);
+  }
+
+private:
+  const char *data;
+  uint32_t size;
+};
+
+// Decompresses one block at a time into a reusable buffer. The blocks come
+// either from a file or from memory, e.g. mapped flash, which needs no
+// buffer for the compressed bytes and serves stored blocks in place.
+class BkzBookStream : public BookStream {
+public:
+  BkzBookStream(FILE *f, const uint8_t *data, const BkzHeader &header,
+                const std::vector<BkzBlock> &blocks)
+      : f(f), data(data), header(header), blocks(blocks), current(UINT32_MAX),
+        current_size(0), view(nullptr),
+        text(std::min(header.block_size, header.text_size)),
+        packed(f ? text.size() : 0) {
+    // Too large for a task stack
+    decompressor = (tinfl_decompressor *)malloc(sizeof(tinfl_decompressor));
+  }
+
+  ~BkzBookStream() {
+    free(decompressor);
+    if (f) {
+      fclose(f);
+    }
+  }
+
+  std::string_view read(uint32_t offset, size_t len) {
+    if (offset >= header.text_size || decompressor == nullptr) {
+      return std::string_view();
+    }
+    uint32_t index = offset / header.block_size;
+    if (index != current && !load(index)) {
+      return std::string_view();
+    }
+    uint32_t start = offset - index * header.block_size;
+    if (len > current_size - start) {
+      len = current_size - start;
+    }
+    return std::string_view(view + start, len);
+  }
+
+private:
+  FILE *f;
+  const uint8_t *data;
+  BkzHeader header;
+  std::vector<BkzBlock> blocks;
+  tinfl_decompressor *decompressor;
+  uint32_t current; // Block held in view
+  uint32_t current_size;
+  const char *view; // Text of the current block
+  std::vector<char> text;
+  std::vector<uint8_t> packed;
+
+  bool load(uint32_t index) {
+    const BkzBlock &block = blocks[index];
+    bool stored = (block.size & BKZ_STORED) != 0;
+    uint32_t size = block.size & ~BKZ_STORED;
+    uint32_t expected = header.text_size - index * header.block_size;
+    if (expected > header.block_size) {
+      expected = header.block_size;
+    }
+    current = UINT32_MAX;
+
+    if (size > header.block_size || (stored && size != expected) ||
+        (f && fseek(f, block.offset, SEEK_SET) != 0)) {
+      ESP_LOGE(TAG, "Bad block %lu", index);
+      return false;
+    }
+
+    const uint8_t *input = data ? data + block.offset : packed.data();
+    if (f) {
+      // Stored blocks go straight to the text buffer
+      uint8_t *target = stored ? (uint8_t *)text.data() : packed.data();
+      if (fread(target, 1, size, f) != size) {
+        ESP_LOGE(TAG, "Short read of block %lu", index);
+        return false;
+      }
+      input = target;
+    }
+
+    if (stored) {
+      view = (const char *)input;
+    } else {
+      size_t in_size = size;
+      size_t out_size = expected;
+      tinfl_init(decompressor);
+      tinfl_status status =
+          tinfl_decompress(decompressor, input, &in_size,
+                           (uint8_t *)text.data(), (uint8_t *)text.data(),
+                           &out_size, TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF);
+      if (status != TINFL_STATUS_DONE || out_size != expected) {
+        ESP_LOGE(TAG, "Failed to inflate block %lu (%d)", index, status);
+        return false;
+      }
+      view = text.data();
+    }
+
+    if (esp_rom_crc32_le(0, (const uint8_t *)view, expected) != block.crc32) {
+      ESP_LOGE(TAG, "Checksum mismatch in block %lu", index);
+      return false;
+    }
+    current = index;
+    current_size = expected;
+    return true;
+  }
+};
+
+FileBookSource::FileBookSource(const char *file_path)
+    : path(file_path), file_size(0), mtime(0) {
+  struct stat st;
+  if (stat(file_path, &st) == 0 && st.st_size > 0) {
+    file_size = (uint32_t)st.st_size;
+    mtime = (int64_t)st.st_mtime;
+  }
+}
+
+BookStream *FileBookSource::stream() {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (f == NULL) {
+    ESP_LOGE(TAG, "Failed to open %s", path.c_str());
+    return nullptr;
+  }
+  return new FileBookStream(f);
+}
+
+BookStream *MemoryBookSource::stream() {
+  return new MemoryBookStream(data, data_size);
+}
+
+// Header fields that every .bkz has to satisfy
+static bool bkz_header_valid(const BkzHeader &h) {
+  return h.magic == BKZ_MAGIC && h.block_size > 0 &&
+         h.block_size <= BKZ_MAX_BLOCK_SIZE &&
+         h.block_count == (h.text_size + h.block_size - 1) / h.block_size;
+}
+
+BkzBookSource::BkzBookSource(const char *file_path)
+    : path(file_path), data(nullptr) {
+  memset(&header, 0, sizeof(header));
+  FILE *f = fopen(file_path, "rb");
+  if (f == NULL) {
+    return;
+  }
+
+  BkzHeader h;
+  bool ok = fread(&h, sizeof(h), 1, f) == 1 && bkz_header_valid(h);
+  if (ok) {
+    blocks.resize(h.block_count);
+    ok = fread(blocks.data(), sizeof(BkzBlock), blocks.size(), f) ==
+         blocks.size();
+  }
+  fclose(f);
+
+  if (!ok) {
+    ESP_LOGE(TAG, "%s is no valid compressed book", file_path);
+    blocks.clear();
+    return;
+  }
+  header = h;
+  ESP_LOGI(TAG, "%s: %lu bytes of text in %lu blocks", file_path,
+           header.text_size, header.block_count);
+}
+
+BkzBookSource::BkzBookSource(const uint8_t *bkz, uint32_t bkz_size)
+    : data(nullptr) {
+  memset(&header, 0, sizeof(header));
+
+  BkzHeader h;
+  bool ok = bkz_size >= sizeof(h);
+  if (ok) {
+    memcpy(&h, bkz, sizeof(h));
+    ok = bkz_header_valid(h) &&
+         h.block_count <= (bkz_size - sizeof(h)) / sizeof(BkzBlock);
+  }
+  if (ok) {
+    blocks.resize(h.block_count);
+    memcpy(blocks.data(), bkz + sizeof(h), blocks.size() * sizeof(BkzBlock));
+  }
+  // Blocks are read in place, so all of them have to lie within the data
+  for (size_t i = 0; ok && i < blocks.size(); i++) {
+    uint32_t size = blocks[i].size & ~BKZ_STORED;
+    ok = blocks[i].offset <= bkz_size && size <= bkz_size - blocks[i].offset;
+  }
+
+  if (!ok) {
+    ESP_LOGE(TAG, "No valid compressed book in memory");
+    blocks.clear();
+    return;
+  }
+  header = h;
+  data = bkz;
+}
+
+BookStream *BkzBookSource::stream() {
+  if (data) {
+    return new BkzBookStream(nullptr, data, header, blocks);
+  }
+  FILE *f = fopen(path.c_str(), "rb");
+  if (f == NULL) {
+    ESP_LOGE(TAG, "Failed to open %s", path.c_str());
+    return nullptr;
+  }
+  return new BkzBookStream(f, nullptr, header, blocks);
+}
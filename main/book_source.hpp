@@ -0,0 +1,158 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Block-compressed book magic, "BKZ1"
+#define BKZ_MAGIC 0x315a4b42
+// Top bit of BkzBlock::size, the block is stored uncompressed
+#define BKZ_STORED 0x80000000u
+// Largest block size accepted
+#define BKZ_MAX_BLOCK_SIZE 16384
+
+/**
+ * @brief Sequential reader of book bytes, one per task
+ */
+class BookStream {
+public:
+  virtual ~BookStream() {}
+
+  /**
+   * @brief Get the bytes at an offset
+   * @param offset Position in the book
+   * @param len Number of bytes wanted
+   * @return Up to len bytes, valid until the next call. Empty at the end of
+   * the book or on errors.
+   */
+  virtual std::string_view read(uint32_t offset, size_t len) = 0;
+};
+
+/**
+ * @brief Where the text of a book comes from
+ */
+class BookSource {
+public:
+  virtual ~BookSource() {}
+
+  // Length of the text in bytes
+  virtual uint32_t size() const = 0;
+
+  // Changes whenever the text does, keys the page index
+  virtual int64_t version() const = 0;
+
+  // Short name for logs
+  virtual const char *kind() const = 0;
+
+  // Create a stream, the caller deletes it. nullptr on errors.
+  virtual BookStream *stream() = 0;
+};
+
+/**
+ * @brief Book stored as a plain file, read through the VFS
+ */
+class FileBookSource : public BookSource {
+public:
+  /**
+   * @brief Stat the file
+   * @param path Full path to the text file
+   */
+  explicit FileBookSource(const char *path);
+
+  // False if the file is missing or empty
+  bool valid() const { return file_size > 0; }
+
+  uint32_t size() const { return file_size; }
+  int64_t version() const { return mtime; }
+  const char *kind() const { return "file"; }
+  BookStream *stream();
+
+private:
+  std::string path;
+  uint32_t file_size;
+  int64_t mtime;
+};
+
+/**
+ * @brief Book that is addressable in memory, e.g. memory mapped flash
+ *
+ * Reads return views into the memory itself, nothing is copied.
+ */
+class MemoryBookSource : public BookSource {
+public:
+  MemoryBookSource(const char *data, uint32_t size, int64_t version)
+      : data(data), data_size(size), data_version(version) {}
+
+  uint32_t size() const { return data_size; }
+  int64_t version() const { return data_version; }
+  const char *kind() const { return "mapped"; }
+  BookStream *stream();
+
+private:
+  const char *data;
+  uint32_t data_size;
+  int64_t data_version;
+};
+
+/**
+ * @brief Header of a block-compressed book, written by tools/pack_bkz.py
+ *
+ * Followed by block_count BkzBlock records and the block data. Each block
+ * holds block_size bytes of text (the last one may be shorter) as a raw
+ * deflate stream.
+ */
+struct BkzHeader {
+  uint32_t magic;
+  uint32_t text_size;
+  uint32_t block_size;
+  uint32_t block_count;
+  uint32_t text_crc32;
+};
+
+struct BkzBlock {
+  uint32_t offset; // From the start of the .bkz
+  uint32_t size;   // Compressed size, or raw size | BKZ_STORED
+  uint32_t crc32;  // Of the uncompressed block
+};
+
+/**
+ * @brief Block-compressed book (.bkz), in a file or in memory
+ *
+ * Streams decompress one block at a time into their own buffer with the
+ * ROM inflater, so a page read touches only the blocks it spans. In memory,
+ * e.g. memory mapped flash, blocks are inflated in place.
+ */
+class BkzBookSource : public BookSource {
+public:
+  /**
+   * @brief Read and check the header and block table
+   * @param path Full path to the .bkz file
+   */
+  explicit BkzBookSource(const char *path);
+
+  /**
+   * @brief Check the header and block table of a book in memory
+   * @param bkz The whole .bkz, must stay valid while streams exist
+   * @param bkz_size Its length in bytes
+   */
+  BkzBookSource(const uint8_t *bkz, uint32_t bkz_size);
+
+  // False if the book is missing or malformed
+  bool valid() const { return header.text_size > 0; }
+
+  uint32_t size() const { return header.text_size; }
+  int64_t version() const { return header.text_crc32; }
+  const char *kind() const {
+    return data ? "mapped compressed" : "compressed";
+  }
+  BookStream *stream();
+
+private:
+  std::string path;
+  const uint8_t *data; // Set for books in memory
+  BkzHeader header;
+  std::vector<BkzBlock> blocks;
+};
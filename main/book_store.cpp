@@ -0,0 +1,89 @@
+#include "book_store.hpp"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "BookStore";
+
+BookStore::BookStore()
+    : data(nullptr), size(0), handle(0), entries(nullptr), count(0) {}
+
+BookStore::~BookStore() {
+  if (data) {
+    esp_partition_munmap(handle);
+  }
+}
+
+esp_err_t BookStore::mount() {
+  if (data) {
+    return ESP_OK;
+  }
+
+  const esp_partition_t *partition =
+      esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                               (esp_partition_subtype_t)BOOK_STORE_SUBTYPE,
+                               BOOK_STORE_PARTITION);
+  if (partition == NULL) {
+    ESP_LOGI(TAG, "No book partition");
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  const void *mapped;
+  esp_err_t err = esp_partition_mmap(partition, 0, partition->size,
+                                     ESP_PARTITION_MMAP_DATA, &mapped, &handle);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to map book partition (%s)", esp_err_to_name(err));
+    return err;
+  }
+
+  const uint8_t *base = (const uint8_t *)mapped;
+  const BookStoreHeader *header = (const BookStoreHeader *)base;
+  size_t directory = sizeof(BookStoreHeader);
+  bool valid = header->magic == BOOK_STORE_MAGIC &&
+               header->count <= (partition->size - directory) /
+                                    sizeof(BookStoreEntry);
+  const BookStoreEntry *table =
+      (const BookStoreEntry *)(base + sizeof(BookStoreHeader));
+
+  // Every book has to lie within the partition
+  for (uint32_t i = 0; valid && i < header->count; i++) {
+    valid = table[i].offset <= partition->size &&
+            table[i].size <= partition->size - table[i].offset &&
+            memchr(table[i].name, 0, BOOK_STORE_NAME_LEN) != NULL;
+  }
+  if (!valid) {
+    ESP_LOGW(TAG, "Book partition holds no valid image");
+    esp_partition_munmap(handle);
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  data = base;
+  size = partition->size;
+  entries = table;
+  count = header->count;
+  ESP_LOGI(TAG, "Mapped %lu books from a %lu byte partition", count, size);
+  return ESP_OK;
+}
+
+BookSource *BookStore::open(const char *name) {
+  for (uint32_t i = 0; i < count; i++) {
+    if (strcmp(entries[i].name, name) != 0 || entries[i].size == 0) {
+      continue;
+    }
+    const uint8_t *book = data + entries[i].offset;
+    uint32_t magic = 0;
+    if (entries[i].size >= sizeof(magic)) {
+      memcpy(&magic, book, sizeof(magic));
+    }
+    if (magic != BKZ_MAGIC) {
+      return new MemoryBookSource((const char *)book, entries[i].size,
+                                  entries[i].crc32);
+    }
+    BkzBookSource *source = new BkzBookSource(book, entries[i].size);
+    if (!source->valid()) {
+      delete source;
+      return nullptr;
+    }
+    return source;
+  }
+  return nullptr;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "book_source.hpp"
+#include "esp_err.h"
+#include "esp_partition.h"
+#include <stdint.h>
+
+// Label and subtype of the read-only book partition
+#define BOOK_STORE_PARTITION "books"
+#define BOOK_STORE_SUBTYPE 0x40
+// Image magic, "BKS1"
+#define BOOK_STORE_MAGIC 0x31534b42
+#define BOOK_STORE_NAME_LEN 32
+
+/**
+ * @brief Header at the start of the book partition, written by
+ * tools/pack_books.py
+ */
+struct BookStoreHeader {
+  uint32_t magic;
+  uint32_t count; // Number of BookStoreEntry records that follow
+};
+
+struct BookStoreEntry {
+  char name[BOOK_STORE_NAME_LEN]; // File name, NUL terminated
+  uint32_t offset;                // From the start of the partition
+  uint32_t size;
+  uint32_t crc32; // Of the content, identifies the version
+};
+
+/**
+ * @brief Read-only books in a raw flash partition
+ *
+ * The whole partition is memory mapped once, books are then read straight
+ * from flash through the cache. Block-compressed books (.bkz) are inflated
+ * from flash a block at a time, plain texts are read without copies.
+ */
+class BookStore {
+public:
+  BookStore();
+  ~BookStore();
+
+  /**
+   * @brief Map the partition and check its directory
+   * @return ESP_OK, ESP_ERR_NOT_FOUND if there is no book partition,
+   * ESP_ERR_INVALID_STATE if it holds no valid image
+   */
+  esp_err_t mount();
+
+  /**
+   * @brief Look a book up by file name
+   * @return New source the caller deletes, nullptr if the book is not here
+   * or is malformed
+   */
+  BookSource *open(const char *name);
+
+private:
+  const uint8_t *data;
+  uint32_t size;
+  esp_partition_mmap_handle_t handle;
+  const BookStoreEntry *entries;
+  uint32_t count;
+};
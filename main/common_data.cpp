@@ -1,7 +1,8 @@
 #include "common_data.hpp"
+#include <string.h>
 
-CommonData::CommonData() {
-  mutex = xSemaphoreCreateMutex();
+CommonData::CommonData() : sequence(0) {
+  portMUX_INITIALIZE(&lock);
 
   // Initialize with default values
   status = {}; // Zero initialize
@@ -13,30 +14,64 @@ CommonData::CommonData() {
   status.wifi_connected = false;
 }
 
-void CommonData::setStatus(const DeviceStatus &new_status) {
-  if (xSemaphoreTake(mutex, portMAX_DELAY)) {
-    status = new_status;
-    xSemaphoreGive(mutex);
-  }
+void CommonData::beginWrite() {
+  portENTER_CRITICAL_SAFE(&lock);
+  sequence.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
 }
 
-void CommonData::setEnvironmental(int co2, float temp, float hum, float alt) {
-  if (xSemaphoreTake(mutex, portMAX_DELAY)) {
-    status.co2_ppm = co2;
-    status.temperature = temp;
-    status.humidity = hum;
-    status.altitude = alt;
-    xSemaphoreGive(mutex);
-  }
+void CommonData::endWrite() {
+  sequence.fetch_add(1, std::memory_order_release);
+  portEXIT_CRITICAL_SAFE(&lock);
 }
 
-DeviceStatus CommonData::getStatus() {
-  DeviceStatus current_status;
-  if (xSemaphoreTake(mutex, portMAX_DELAY)) {
-    current_status = status;
-    xSemaphoreGive(mutex);
-  }
-  return current_status;
+void CommonData::setEnvironmental(int co2, float temp, float hum) {
+  beginWrite();
+  status.co2_ppm = co2;
+  status.temperature = temp;
+  status.humidity = hum;
+  endWrite();
+}
+
+void CommonData::setAltitude(float alt) {
+  beginWrite();
+  status.altitude = alt;
+  endWrite();
+}
+
+void CommonData::setBatteryVoltage(float voltage) {
+  beginWrite();
+  status.battery_voltage = voltage;
+  endWrite();
+}
+
+void CommonData::setWifiConnected(bool connected) {
+  beginWrite();
+  status.wifi_connected = connected;
+  endWrite();
+}
+
+void CommonData::setTouch4(bool active) {
+  beginWrite();
+  status.touch_4 = active;
+  endWrite();
+}
+
+void CommonData::setTouch5(bool active) {
+  beginWrite();
+  status.touch_5 = active;
+  endWrite();
+}
+
+DeviceStatus CommonData::getStatus() const {
+  DeviceStatus snapshot;
+  uint32_t start;
+  do {
+    start = sequence.load(std::memory_order_acquire);
+    memcpy(&snapshot, (const void *)&status, sizeof(snapshot));
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while ((start & 1) || start != sequence.load(std::memory_order_relaxed));
+  return snapshot;
 }
 
 // Instantiate global object
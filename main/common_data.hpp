@@ -1,7 +1,7 @@
 #pragma once
 
 #include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
+#include <atomic>
 #include <stdint.h>
 
 #include <time.h>
@@ -25,20 +25,35 @@ struct DeviceStatus {
   bool touch_5;
 };
 
+/**
+ * @brief Shared status protected by a sequence lock
+ *
+ * Writers update single fields inside a short critical section and bump the
+ * sequence counter before and after, so they may run in tasks or ISRs.
+ * Readers never block: they copy the struct and retry if a write overlapped.
+ */
 class CommonData {
 public:
   CommonData();
 
-  // Thread-safe setters
-  void setStatus(const DeviceStatus &new_status);
-  void setEnvironmental(int co2, float temp, float hum, float alt);
+  // Field setters, safe from tasks and ISRs
+  void setEnvironmental(int co2, float temp, float hum);
+  void setAltitude(float alt);
+  void setBatteryVoltage(float voltage);
+  void setWifiConnected(bool connected);
+  void setTouch4(bool active);
+  void setTouch5(bool active);
 
-  // Thread-safe getter
-  DeviceStatus getStatus();
+  // Consistent snapshot, never blocks, safe from tasks and ISRs
+  DeviceStatus getStatus() const;
 
 private:
   DeviceStatus status;
-  SemaphoreHandle_t mutex;
+  std::atomic<uint32_t> sequence; // Odd while a write is in progress
+  portMUX_TYPE lock;              // Serializes writers
+
+  void beginWrite();
+  void endWrite();
 };
 
 // Global instance
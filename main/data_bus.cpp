@@ -0,0 +1,140 @@
+#include "data_bus.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "DataBus";
+
+DataBus::DataBus() {
+  portMUX_INITIALIZE(&lock);
+  memset(subscribers, 0, sizeof(subscribers));
+}
+
+int DataBus::add(const Subscriber &subscriber) {
+  int id = -1;
+  portENTER_CRITICAL(&lock);
+  for (int i = 0; i < DATA_BUS_MAX_SUBSCRIBERS; i++) {
+    if (subscribers[i].kind == SUB_NONE) {
+      subscribers[i] = subscriber;
+      for (int t = 0; t < TOPIC_COUNT; t++) {
+        subscribers[i].last[t] = NAN;
+      }
+      id = i;
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&lock);
+
+  if (id < 0) {
+    ESP_LOGE(TAG, "No free subscriber slots");
+  }
+  return id;
+}
+
+int DataBus::subscribeQueue(const DataFilter &filter, QueueHandle_t queue) {
+  Subscriber subscriber = {};
+  subscriber.kind = SUB_QUEUE;
+  subscriber.filter = filter;
+  subscriber.queue = queue;
+  return add(subscriber);
+}
+
+int DataBus::subscribeNotify(const DataFilter &filter, TaskHandle_t task) {
+  Subscriber subscriber = {};
+  subscriber.kind = SUB_NOTIFY;
+  subscriber.filter = filter;
+  subscriber.task = task;
+  return add(subscriber);
+}
+
+int DataBus::subscribeCallback(const DataFilter &filter, DataCallback callback,
+                               void *ctx) {
+  Subscriber subscriber = {};
+  subscriber.kind = SUB_CALLBACK;
+  subscriber.filter = filter;
+  subscriber.callback = callback;
+  subscriber.ctx = ctx;
+  return add(subscriber);
+}
+
+void DataBus::unsubscribe(int id) {
+  if (id < 0 || id >= DATA_BUS_MAX_SUBSCRIBERS)
+    return;
+  portENTER_CRITICAL(&lock);
+  subscribers[id].kind = SUB_NONE;
+  portEXIT_CRITICAL(&lock);
+}
+
+bool DataBus::accept(Subscriber &subscriber, const DataSample &sample) {
+  if (!(subscriber.filter.topics & DATA_TOPIC_BIT(sample.topic)))
+    return false;
+
+  float last = subscriber.last[sample.topic];
+  if (!isnan(last) && subscriber.filter.min_delta > 0 &&
+      fabsf(sample.value - last) < subscriber.filter.min_delta) {
+    return false;
+  }
+  if (subscriber.filter.predicate &&
+      !subscriber.filter.predicate(sample, last,
+                                   subscriber.filter.predicate_ctx)) {
+    return false;
+  }
+  subscriber.last[sample.topic] = sample.value;
+  return true;
+}
+
+void DataBus::dispatch(const DataSample &sample, bool from_isr,
+                       BaseType_t *woken) {
+  for (int i = 0; i < DATA_BUS_MAX_SUBSCRIBERS; i++) {
+    // Filter and take a copy under the lock, deliver outside of it
+    Subscriber subscriber;
+    bool deliver = false;
+    portENTER_CRITICAL_SAFE(&lock);
+    if (subscribers[i].kind != SUB_NONE) {
+      deliver = accept(subscribers[i], sample);
+      subscriber = subscribers[i];
+    }
+    portEXIT_CRITICAL_SAFE(&lock);
+    if (!deliver)
+      continue;
+
+    switch (subscriber.kind) {
+    case SUB_QUEUE:
+      if (from_isr) {
+        xQueueSendFromISR(subscriber.queue, &sample, woken);
+      } else {
+        xQueueSend(subscriber.queue, &sample, 0);
+      }
+      break;
+    case SUB_NOTIFY:
+      if (from_isr) {
+        xTaskNotifyFromISR(subscriber.task, DATA_TOPIC_BIT(sample.topic),
+                           eSetBits, woken);
+      } else {
+        xTaskNotify(subscriber.task, DATA_TOPIC_BIT(sample.topic), eSetBits);
+      }
+      break;
+    case SUB_CALLBACK:
+      subscriber.callback(sample, subscriber.ctx);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+void DataBus::publish(DataTopic topic, float value, int32_t arg) {
+  DataSample sample = {topic, value, arg, esp_timer_get_time()};
+  dispatch(sample, false, nullptr);
+}
+
+bool DataBus::publishFromISR(DataTopic topic, float value, int32_t arg) {
+  DataSample sample = {topic, value, arg, esp_timer_get_time()};
+  BaseType_t woken = pdFALSE;
+  dispatch(sample, true, &woken);
+  return woken == pdTRUE;
+}
+
+// Instantiate global object
+DataBus data_bus;
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include <stdint.h>
+
+// Maximum number of concurrent subscriptions
+#define DATA_BUS_MAX_SUBSCRIBERS 8
+
+enum DataTopic {
+  TOPIC_CO2,         // ppm
+  TOPIC_TEMPERATURE, // degrees C
+  TOPIC_HUMIDITY,    // %RH
+  TOPIC_BATTERY,     // volts
+  TOPIC_WIFI,        // 1 connected, 0 disconnected
+  TOPIC_INPUT,       // 1 pressed, 0 released, arg is the UiButton
+  TOPIC_COUNT,
+};
+
+#define DATA_TOPIC_BIT(topic) (1u << (topic))
+
+/**
+ * @brief Value published on a topic
+ */
+struct DataSample {
+  DataTopic topic;
+  float value;
+  int32_t arg;
+  int64_t time_us;
+};
+
+// Optional filter, return true if the sample is worth delivering. last is
+// the value last delivered to this subscriber, NAN if none yet.
+typedef bool (*DataPredicate)(const DataSample &sample, float last, void *ctx);
+
+// Called in the publisher's context, which is an ISR for TOPIC_INPUT
+typedef void (*DataCallback)(const DataSample &sample, void *ctx);
+
+/**
+ * @brief What a subscriber listens to and how it filters samples
+ */
+struct DataFilter {
+  uint32_t topics;         // DATA_TOPIC_BIT() mask
+  float min_delta;         // Skip changes smaller than this, 0 passes all
+  DataPredicate predicate; // Optional, applied after min_delta
+  void *predicate_ctx;
+};
+
+/**
+ * @brief Publish/subscribe bus for status changes
+ *
+ * Producers publish samples without knowing who listens. Subscribers get
+ * them through a queue (DataSample items), a task notification (topic bits
+ * set in the notification value) or a callback. Queue and notification
+ * subscribers cost nothing until a sample passes their filter.
+ */
+class DataBus {
+public:
+  DataBus();
+
+  /**
+   * @brief Subscribe a queue of DataSample items
+   * @return Subscription id, or -1 if the table is full
+   */
+  int subscribeQueue(const DataFilter &filter, QueueHandle_t queue);
+
+  /**
+   * @brief Subscribe a task, DATA_TOPIC_BIT(topic) is ORed into its
+   * notification value
+   * @return Subscription id, or -1 if the table is full
+   */
+  int subscribeNotify(const DataFilter &filter, TaskHandle_t task);
+
+  /**
+   * @brief Subscribe a callback
+   * @return Subscription id, or -1 if the table is full
+   */
+  int subscribeCallback(const DataFilter &filter, DataCallback callback,
+                        void *ctx);
+
+  void unsubscribe(int id);
+
+  // Publish from task context
+  void publish(DataTopic topic, float value, int32_t arg = 0);
+
+  // Publish from an ISR, returns true if a higher priority task was woken
+  bool publishFromISR(DataTopic topic, float value, int32_t arg = 0);
+
+private:
+  enum SubscriberKind { SUB_NONE, SUB_QUEUE, SUB_NOTIFY, SUB_CALLBACK };
+
+  struct Subscriber {
+    SubscriberKind kind;
+    DataFilter filter;
+    QueueHandle_t queue;
+    TaskHandle_t task;
+    DataCallback callback;
+    void *ctx;
+    float last[TOPIC_COUNT]; // Last delivered value per topic
+  };
+
+  Subscriber subscribers[DATA_BUS_MAX_SUBSCRIBERS];
+  portMUX_TYPE lock;
+
+  int add(const Subscriber &subscriber);
+  bool accept(Subscriber &subscriber, const DataSample &sample);
+  void dispatch(const DataSample &sample, bool from_isr, BaseType_t *woken);
+};
+
+// Global instance
+extern DataBus data_bus;
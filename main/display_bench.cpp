@@ -0,0 +1,114 @@
+#include "display_bench.hpp"
+#include "Fonts/FreeSans7pt7b.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "DisplayBench";
+
+// Passes per case, each alternating between black and white
+#define BENCH_ITERATIONS 1000
+
+// A reader line, drawn with the reader font
+static const char *bench_text = "The quick brown fox jumps over the lazy dog";
+
+typedef void (*BenchFn)(Adafruit_SSD1680 *display, uint16_t color);
+
+static void pixelRect(Adafruit_SSD1680 *display, int16_t x, int16_t y,
+                      int16_t w, int16_t h, uint16_t color) {
+  for (int16_t j = y; j < y + h; j++) {
+    for (int16_t i = x; i < x + w; i++) {
+      display->drawPixel(i, j, color);
+    }
+  }
+}
+
+static void fastFillRect(Adafruit_SSD1680 *display, uint16_t color) {
+  display->fillRect(20, 20, 200, 80, color);
+}
+
+static void slowFillRect(Adafruit_SSD1680 *display, uint16_t color) {
+  pixelRect(display, 20, 20, 200, 80, color);
+}
+
+static void fastHLine(Adafruit_SSD1680 *display, uint16_t color) {
+  display->drawFastHLine(0, 64, 296, color);
+}
+
+static void slowHLine(Adafruit_SSD1680 *display, uint16_t color) {
+  pixelRect(display, 0, 64, 296, 1, color);
+}
+
+static void fastVLine(Adafruit_SSD1680 *display, uint16_t color) {
+  display->drawFastVLine(148, 0, 128, color);
+}
+
+static void slowVLine(Adafruit_SSD1680 *display, uint16_t color) {
+  pixelRect(display, 148, 0, 1, 128, color);
+}
+
+static void fastFillScreen(Adafruit_SSD1680 *display, uint16_t color) {
+  display->fillScreen(color);
+}
+
+static void slowFillScreen(Adafruit_SSD1680 *display, uint16_t color) {
+  pixelRect(display, 0, 0, display->width(), display->height(), color);
+}
+
+static void fastText(Adafruit_SSD1680 *display, uint16_t color) {
+  display->setTextColor(color);
+  display->setCursor(0, 60);
+  for (const char *c = bench_text; *c; c++) {
+    display->write(*c);
+  }
+}
+
+static void slowText(Adafruit_SSD1680 *display, uint16_t color) {
+  // The generic GFX write draws custom font glyphs pixel by pixel
+  display->setTextColor(color);
+  display->setCursor(0, 60);
+  for (const char *c = bench_text; *c; c++) {
+    display->Adafruit_GFX::write(*c);
+  }
+}
+
+// Nanoseconds per call. A first untimed pass fills the glyph cache.
+static int64_t timeCase(Adafruit_SSD1680 *display, BenchFn fn) {
+  fn(display, GFX_BLACK);
+  int64_t start = esp_timer_get_time();
+  for (int i = 0; i < BENCH_ITERATIONS; i++) {
+    fn(display, (i & 1) ? GFX_BLACK : GFX_WHITE);
+  }
+  return (esp_timer_get_time() - start) * 1000 / BENCH_ITERATIONS;
+}
+
+void display_benchmark(Adafruit_SSD1680 *display) {
+  struct {
+    const char *name;
+    BenchFn fast;
+    BenchFn slow;
+  } cases[] = {
+      {"fillRect 200x80", fastFillRect, slowFillRect},
+      {"drawFastHLine", fastHLine, slowHLine},
+      {"drawFastVLine", fastVLine, slowVLine},
+      {"fillScreen", fastFillScreen, slowFillScreen},
+      {"write 43 chars", fastText, slowText},
+  };
+
+  // UI orientation and reader font
+  display->setRotation(3);
+  display->setFont(&FreeSans7pt7b);
+  display->setTextWrap(false);
+
+  for (const auto &c : cases) {
+    display->clearBuffer();
+    int64_t fast_ns = timeCase(display, c.fast);
+    display->clearBuffer();
+    int64_t slow_ns = timeCase(display, c.slow);
+    int64_t tenths = fast_ns > 0 ? slow_ns * 10 / fast_ns : 0;
+    ESP_LOGI(TAG, "%-16s %8lld ns, drawPixel %9lld ns, %lld.%lldx", c.name,
+             fast_ns, slow_ns, tenths / 10, tenths % 10);
+  }
+
+  display->setFont(NULL);
+  display->clearBuffer();
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "display_manager.hpp"
+
+// Run the drawing benchmark at startup, before the UI takes the display
+#define DISPLAY_RUN_BENCHMARK 0
+
+/**
+ * @brief Time the byte-wide drawing primitives against the drawPixel path
+ *
+ * Every case is drawn both ways with alternating colors, so each pass
+ * changes pixels, and the per call times and speedups are logged. Draws
+ * into the back buffer and clears it afterwards, so run it before the UI
+ * task starts.
+ */
+void display_benchmark(Adafruit_SSD1680 *display);
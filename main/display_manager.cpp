@@ -14,24 +14,74 @@ static const char *TAG = "DisplayManager";
 // --- Adafruit_SSD1680 implementation ---
 
 Adafruit_SSD1680::Adafruit_SSD1680(int16_t w, int16_t h,
+                                   esp_lcd_panel_io_handle_t io,
                                    esp_lcd_panel_handle_t handle,
                                    SemaphoreHandle_t semaphore)
-    : Adafruit_GFX(w, h), panel_handle(handle),
-      epaper_panel_semaphore(semaphore) {
+    : Adafruit_GFX(w, h), io_handle(io), panel_handle(handle),
+      epaper_panel_semaphore(semaphore), layer_saved_buffer(nullptr),
+      flush_task_handle(NULL), frame_locked(false), frame_pending(false),
+      clean_requested(false), frame_quality(REFRESH_FAST),
+      front_buffer(nullptr), window_buffer(nullptr), buffers_leased(false),
+      shadow_buffer(nullptr), shadow_valid(false), panel_valid(false),
+      active_lut(LUT_PROFILE_CLEAN), refresh_lut(LUT_PROFILE_CLEAN),
+      refresh_start_us(0), refresh_end_us(0) {
+
+  stats = {};
+  dirty.reset();
+  layer_saved_dirty.reset();
+  flush_window.reset();
+  frame_mutex = xSemaphoreCreateMutex();
 
   buffer_size = (w * h) / 8;
-  buffer = (uint8_t *)heap_caps_malloc(buffer_size, MALLOC_CAP_DMA);
+  buffer = (uint8_t *)heap_caps_malloc(buffer_size, MALLOC_CAP_8BIT);
   if (!buffer) {
     ESP_LOGE(TAG, "Failed to allocate graphics buffer!");
   } else {
     memset(buffer, 0xFF, buffer_size); // Clear to white
   }
+
+  front_buffer = (uint8_t *)heap_caps_malloc(buffer_size, MALLOC_CAP_DMA);
+  if (!front_buffer) {
+    ESP_LOGE(TAG, "Failed to allocate front buffer!");
+  } else {
+    memset(front_buffer, 0xFF, buffer_size);
+  }
+
+  window_buffer = (uint8_t *)heap_caps_malloc(buffer_size, MALLOC_CAP_DMA);
+  if (!window_buffer) {
+    ESP_LOGW(TAG, "Failed to allocate window buffer, using full uploads");
+  }
+
+  shadow_buffer = (uint8_t *)heap_caps_malloc(buffer_size, MALLOC_CAP_8BIT);
+  if (!shadow_buffer) {
+    ESP_LOGW(TAG, "Failed to allocate shadow buffer, frame diff disabled");
+  }
 }
 
 Adafruit_SSD1680::~Adafruit_SSD1680() {
+  if (flush_task_handle) {
+    vTaskDelete(flush_task_handle);
+  }
   if (buffer) {
     free(buffer);
   }
+  if (front_buffer) {
+    free(front_buffer);
+  }
+  if (window_buffer) {
+    free(window_buffer);
+  }
+  if (shadow_buffer) {
+    free(shadow_buffer);
+  }
+  if (frame_mutex) {
+    vSemaphoreDelete(frame_mutex);
+  }
+}
+
+void Adafruit_SSD1680::start() {
+  xTaskCreate(flushTaskEntry, "epd_flush_task", 3072, this, 5,
+              &flush_task_handle);
 }
 
 void Adafruit_SSD1680::drawPixel(int16_t x, int16_t y, uint16_t color) {
@@ -64,46 +114,620 @@ void Adafruit_SSD1680::drawPixel(int16_t x, int16_t y, uint16_t color) {
   uint32_t byte_idx = idx / 8;
   uint8_t bit_idx = 7 - (idx % 8);
 
+  uint8_t old_byte = buffer[byte_idx];
+  uint8_t new_byte;
   if (color == GFX_BLACK) {
-    buffer[byte_idx] &= ~(1 << bit_idx); // Clear bit -> Black
+    new_byte = old_byte & ~(1 << bit_idx); // Clear bit -> Black
   } else {
-    buffer[byte_idx] |= (1 << bit_idx); // Set bit -> White
+    new_byte = old_byte | (1 << bit_idx); // Set bit -> White
+  }
+
+  // Only pixels that actually change widen the dirty window
+  if (new_byte != old_byte) {
+    buffer[byte_idx] = new_byte;
+    dirty.mark(x / 8, y);
   }
 }
 
-void Adafruit_SSD1680::clearBuffer() {
-  if (buffer) {
-    memset(buffer, 0xFF, buffer_size);
+void Adafruit_SSD1680::fillPanelRect(int16_t px, int16_t py, int16_t pw,
+                                     int16_t ph, uint16_t color) {
+  int16_t c0 = px / 8;
+  int16_t c1 = (px + pw - 1) / 8;
+  uint8_t lmask = 0xFF >> (px & 7);
+  uint8_t rmask = 0xFF << (7 - ((px + pw - 1) & 7));
+  if (c0 == c1) {
+    lmask &= rmask;
+  }
+  uint8_t fill = (color == GFX_BLACK) ? 0x00 : 0xFF;
+
+  // The dirty window is a bounding box, so the first and last changed rows
+  // are all it needs
+  int16_t first_row = -1;
+  int16_t last_row = -1;
+
+  for (int16_t row = py; row < py + ph; row++) {
+    uint8_t *line = buffer + row * EPD_ROW_BYTES;
+    bool changed = false;
+
+    // Partial edge bytes
+    uint8_t old_byte = line[c0];
+    line[c0] = (old_byte & ~lmask) | (fill & lmask);
+    changed |= (line[c0] != old_byte);
+    if (c1 > c0) {
+      old_byte = line[c1];
+      line[c1] = (old_byte & ~rmask) | (fill & rmask);
+      changed |= (line[c1] != old_byte);
+    }
+
+    // Whole bytes in between
+    for (int16_t col = c0 + 1; col < c1; col++) {
+      if (line[col] != fill) {
+        line[col] = fill;
+        changed = true;
+      }
+    }
+
+    if (changed) {
+      if (first_row < 0) {
+        first_row = row;
+      }
+      last_row = row;
+    }
+  }
+
+  if (first_row >= 0) {
+    dirty.mark(c0, first_row);
+    dirty.mark(c1, last_row);
+  }
+}
+
+void Adafruit_SSD1680::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                                uint16_t color) {
+  if (!buffer || !clipRect(x, y, w, h))
+    return;
+
+  int16_t px, py, pw, ph;
+  mapRect(x, y, w, h, px, py, pw, ph);
+  fillPanelRect(px, py, pw, ph, color);
+}
+
+bool Adafruit_SSD1680::clipRect(int16_t &x, int16_t &y, int16_t &w,
+                                int16_t &h) const {
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+
+  // Clip in logical coordinates
+  if (x < 0) {
+    w += x;
+    x = 0;
+  }
+  if (y < 0) {
+    h += y;
+    y = 0;
+  }
+  if (x + w > _width)
+    w = _width - x;
+  if (y + h > _height)
+    h = _height - y;
+  return w > 0 && h > 0;
+}
+
+void Adafruit_SSD1680::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                     uint16_t color) {
+  fillRect(x, y, 1, h, color);
+}
+
+void Adafruit_SSD1680::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                     uint16_t color) {
+  fillRect(x, y, w, 1, color);
+}
+
+void Adafruit_SSD1680::fillScreen(uint16_t color) {
+  if (!buffer)
+    return;
+
+  uint8_t fill = (color == GFX_BLACK) ? 0x00 : 0xFF;
+
+  // Only bytes that are not already the fill value become dirty
+  for (int16_t row = 0; row < EPD_HEIGHT; row++) {
+    const uint8_t *line = buffer + row * EPD_ROW_BYTES;
+    for (int16_t col = 0; col < EPD_ROW_BYTES; col++) {
+      if (line[col] != fill) {
+        dirty.mark(col, row);
+      }
+    }
+  }
+  memset(buffer, fill, buffer_size);
+}
+
+void Adafruit_SSD1680::clearBuffer() { fillScreen(GFX_WHITE); }
+
+uint8_t *Adafruit_SSD1680::allocLayer(bool external) {
+  uint8_t *layer;
+  if (external) {
+    layer = (uint8_t *)heap_caps_malloc_prefer(
+        buffer_size, 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, MALLOC_CAP_8BIT);
+  } else {
+    layer = (uint8_t *)heap_caps_malloc(buffer_size, MALLOC_CAP_8BIT);
+  }
+  if (!layer) {
+    ESP_LOGW(TAG, "Failed to allocate layer buffer");
+  }
+  return layer;
+}
+
+void Adafruit_SSD1680::saveLayer(uint8_t *layer) {
+  if (buffer && layer) {
+    memcpy(layer, buffer, buffer_size);
+  }
+}
+
+void Adafruit_SSD1680::loadLayer(const uint8_t *layer) {
+  if (!buffer || !layer)
+    return;
+
+  for (int16_t row = 0; row < EPD_HEIGHT; row++) {
+    uint8_t *dst = buffer + row * EPD_ROW_BYTES;
+    const uint8_t *src = layer + row * EPD_ROW_BYTES;
+    if (memcmp(dst, src, EPD_ROW_BYTES) == 0)
+      continue;
+    for (int16_t col = 0; col < EPD_ROW_BYTES; col++) {
+      if (dst[col] != src[col]) {
+        dst[col] = src[col];
+        dirty.mark(col, row);
+      }
+    }
   }
 }
 
-void Adafruit_SSD1680::display(bool partial) {
-  if (!buffer || !panel_handle || !epaper_panel_semaphore)
+void Adafruit_SSD1680::loadLayerRect(const uint8_t *layer, int16_t x,
+                                     int16_t y, int16_t w, int16_t h) {
+  if (!buffer || !layer || !clipRect(x, y, w, h))
     return;
 
-  // Wait for previous operation to complete
-  xSemaphoreTake(epaper_panel_semaphore, portMAX_DELAY);
+  int16_t px, py, pw, ph;
+  mapRect(x, y, w, h, px, py, pw, ph);
+
+  int16_t c0 = px / 8;
+  int16_t c1 = (px + pw - 1) / 8;
+  uint8_t lmask = 0xFF >> (px & 7);
+  uint8_t rmask = 0xFF << (7 - ((px + pw - 1) & 7));
+
+  for (int16_t row = py; row < py + ph; row++) {
+    uint8_t *dst = buffer + row * EPD_ROW_BYTES;
+    const uint8_t *src = layer + row * EPD_ROW_BYTES;
+    for (int16_t col = c0; col <= c1; col++) {
+      uint8_t mask = 0xFF;
+      if (col == c0)
+        mask &= lmask;
+      if (col == c1)
+        mask &= rmask;
+      uint8_t new_byte = (dst[col] & ~mask) | (src[col] & mask);
+      if (new_byte != dst[col]) {
+        dst[col] = new_byte;
+        dirty.mark(col, row);
+      }
+    }
+  }
+}
+
+bool Adafruit_SSD1680::blitGlyph(const CachedGlyph &glyph, int16_t px,
+                                 int16_t py, uint16_t color) {
+  if (px < 0 || py < 0 || px + glyph.cols > EPD_WIDTH ||
+      py + glyph.rows > EPD_HEIGHT)
+    return false;
+
+  int16_t c0 = px / 8;
+  uint8_t shift = px & 7;
+  const uint8_t *src = glyph.bits;
+
+  for (int16_t row = py; row < py + glyph.rows; row++) {
+    uint8_t *line = buffer + row * EPD_ROW_BYTES + c0;
+    bool changed = false;
+
+    for (uint8_t i = 0; i < glyph.stride; i++) {
+      uint8_t bits = src[i];
+      if (!bits)
+        continue;
+      // Each source byte straddles at most two framebuffer bytes. Padding
+      // bits are zero, so a non-zero spill never runs past the panel edge.
+      uint8_t parts[2] = {(uint8_t)(bits >> shift),
+                          (uint8_t)(shift ? bits << (8 - shift) : 0)};
+      for (uint8_t j = 0; j < 2; j++) {
+        if (!parts[j])
+          continue;
+        uint8_t old_byte = line[i + j];
+        uint8_t new_byte = (color == GFX_BLACK) ? (old_byte & ~parts[j])
+                                                : (old_byte | parts[j]);
+        if (new_byte != old_byte) {
+          line[i + j] = new_byte;
+          changed = true;
+        }
+      }
+    }
+
+    if (changed) {
+      dirty.mark(c0, row);
+      dirty.mark((px + glyph.cols - 1) / 8, row);
+    }
+    src += glyph.stride;
+  }
+  return true;
+}
+
+size_t Adafruit_SSD1680::write(uint8_t c) {
+  // Built-in and scaled fonts keep the generic per-pixel path
+  if (!gfxFont || textsize_x != 1 || textsize_y != 1 || !buffer) {
+    return Adafruit_GFX::write(c);
+  }
+
+  // Same cursor handling as Adafruit_GFX::write for custom fonts
+  if (c == '\n') {
+    cursor_x = 0;
+    cursor_y += (uint8_t)gfxFont->yAdvance;
+    return 1;
+  }
+  if (c == '\r' || c < gfxFont->first || c > gfxFont->last) {
+    return 1;
+  }
+
+  const GFXglyph *glyph = gfxFont->glyph + (c - gfxFont->first);
+  uint8_t w = glyph->width;
+  uint8_t h = glyph->height;
+  if (w > 0 && h > 0) {
+    int16_t xo = glyph->xOffset;
+    int16_t yo = glyph->yOffset;
+    if (wrap && ((cursor_x + xo + w) > _width)) {
+      cursor_x = 0;
+      cursor_y += (uint8_t)gfxFont->yAdvance;
+    }
+
+    const CachedGlyph *cached = glyph_cache.get(gfxFont, c, rotation);
+    int16_t px, py, pw, ph;
+    mapRect(cursor_x + xo, cursor_y + yo, w, h, px, py, pw, ph);
+    if (!cached || !blitGlyph(*cached, px, py, textcolor)) {
+      // Clipped or uncached glyph, let the pixel path handle clipping
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, 1, 1);
+    }
+  }
+  cursor_x += (uint8_t)glyph->xAdvance;
+  return 1;
+}
+
+void Adafruit_SSD1680::trimWindowToShadow() {
+  if (flush_window.empty())
+    return;
+
+  DirtyWindow window = flush_window;
+  flush_window.reset();
+  for (int16_t row = window.y0; row <= window.y1; row++) {
+    const uint8_t *cur = front_buffer + row * EPD_ROW_BYTES;
+    const uint8_t *old = shadow_buffer + row * EPD_ROW_BYTES;
+    if (memcmp(cur + window.x0, old + window.x0, window.x1 - window.x0 + 1) ==
+        0)
+      continue;
+    for (int16_t col = window.x0; col <= window.x1; col++) {
+      if (cur[col] != old[col]) {
+        flush_window.mark(col, row);
+      }
+    }
+  }
+}
+
+void Adafruit_SSD1680::updateShadow(bool full) {
+  if (!shadow_buffer)
+    return;
+
+  if (full) {
+    memcpy(shadow_buffer, front_buffer, buffer_size);
+    shadow_valid = true;
+  } else if (!flush_window.empty()) {
+    int16_t cols = flush_window.x1 - flush_window.x0 + 1;
+    for (int16_t row = flush_window.y0; row <= flush_window.y1; row++) {
+      size_t offset = row * EPD_ROW_BYTES + flush_window.x0;
+      memcpy(shadow_buffer + offset, front_buffer + offset, cols);
+    }
+  }
+}
+
+const uint8_t *Adafruit_SSD1680::prepareFlushWindow(int16_t &x_start,
+                                                   int16_t &cols) {
+  cols = flush_window.x1 - flush_window.x0 + 1;
+  x_start = 0;
+
+  if (cols == EPD_ROW_BYTES || !window_buffer) {
+    // Full-width band is contiguous in the framebuffer, send it in place
+    cols = EPD_ROW_BYTES;
+    return front_buffer + flush_window.y0 * EPD_ROW_BYTES;
+  }
+
+  // Pack the window rows so the controller gets them back to back
+  uint8_t *dst = window_buffer;
+  for (int16_t row = flush_window.y0; row <= flush_window.y1; row++) {
+    memcpy(dst, front_buffer + row * EPD_ROW_BYTES + flush_window.x0, cols);
+    dst += cols;
+  }
+  x_start = flush_window.x0 * 8;
+  return window_buffer;
+}
+
+size_t Adafruit_SSD1680::uploadWindow(const uint8_t *data, int16_t x_start,
+                                      int16_t cols) {
+  int16_t rows = flush_window.y1 - flush_window.y0 + 1;
+  buffers_leased = true;
+  esp_lcd_panel_draw_bitmap(panel_handle, x_start, flush_window.y0,
+                            x_start + cols * 8, flush_window.y0 + rows, data);
+  return (size_t)cols * rows;
+}
+
+void Adafruit_SSD1680::fenceTransfers() {
+  if (!buffers_leased)
+    return;
+
+  // A parameter-less transaction only returns once every queued color
+  // transfer has completed, after that the driver holds no buffer pointer
+  esp_lcd_panel_io_tx_param(io_handle, -1, NULL, 0);
+  buffers_leased = false;
+}
+
+void Adafruit_SSD1680::beginLayer(uint8_t *layer) {
+  xSemaphoreTake(frame_mutex, portMAX_DELAY);
+  layer_saved_buffer = buffer;
+  layer_saved_dirty = dirty;
+  buffer = layer;
+  dirty.reset();
+}
+
+void Adafruit_SSD1680::endLayer() {
+  buffer = layer_saved_buffer;
+  dirty = layer_saved_dirty;
+  layer_saved_buffer = nullptr;
+  xSemaphoreGive(frame_mutex);
+}
+
+bool Adafruit_SSD1680::framePending() {
+  xSemaphoreTake(frame_mutex, portMAX_DELAY);
+  bool pending = frame_pending;
+  xSemaphoreGive(frame_mutex);
+  return pending;
+}
+
+void Adafruit_SSD1680::beginFrame() {
+  xSemaphoreTake(frame_mutex, portMAX_DELAY);
+  frame_locked = true;
+}
+
+void Adafruit_SSD1680::display(RefreshQuality quality) {
+  if (!buffer || !front_buffer || !panel_handle || !epaper_panel_semaphore)
+    return;
+
+  if (!frame_locked) {
+    xSemaphoreTake(frame_mutex, portMAX_DELAY);
+  }
+  if (frame_pending) {
+    stats.coalesced_frames++;
+    if (quality < frame_quality) {
+      quality = frame_quality;
+    }
+  }
+  if (clean_requested) {
+    quality = REFRESH_CLEAN;
+    clean_requested = false;
+  }
+  frame_quality = quality;
+  frame_pending = true;
+  frame_locked = false;
+  xSemaphoreGive(frame_mutex);
+
+  if (flush_task_handle) {
+    xTaskNotifyGive(flush_task_handle);
+  }
+}
+
+void Adafruit_SSD1680::requestCleanRefresh() {
+  xSemaphoreTake(frame_mutex, portMAX_DELAY);
+  clean_requested = true;
+  xSemaphoreGive(frame_mutex);
+}
+
+DisplayStats Adafruit_SSD1680::getStats() {
+  xSemaphoreTake(frame_mutex, portMAX_DELAY);
+  DisplayStats snapshot = stats;
+  xSemaphoreGive(frame_mutex);
+  return snapshot;
+}
+
+void Adafruit_SSD1680::flushTaskEntry(void *param) {
+  Adafruit_SSD1680 *instance = (Adafruit_SSD1680 *)param;
+  instance->flushLoop();
+}
+
+bool Adafruit_SSD1680::takeFrame(RefreshQuality &quality) {
+  xSemaphoreTake(frame_mutex, portMAX_DELAY);
+  if (!frame_pending) {
+    xSemaphoreGive(frame_mutex);
+    return false;
+  }
+
+  // Copy everything when a full refresh is likely, otherwise only the rows
+  // that changed. Outside the dirty rows the front buffer already matches.
+  quality = frame_quality;
+  if (quality == REFRESH_CLEAN || !panel_valid) {
+    memcpy(front_buffer, buffer, buffer_size);
+  } else if (!dirty.empty()) {
+    memcpy(front_buffer + dirty.y0 * EPD_ROW_BYTES,
+           buffer + dirty.y0 * EPD_ROW_BYTES,
+           (dirty.y1 - dirty.y0 + 1) * EPD_ROW_BYTES);
+  }
+  flush_window.merge(dirty);
+  dirty.reset();
+  frame_pending = false;
+  xSemaphoreGive(frame_mutex);
+  return true;
+}
+
+void Adafruit_SSD1680::flushLoop() {
+  while (1) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    // The front buffer is about to be overwritten, get it back from the
+    // SPI driver first
+    fenceTransfers();
+
+    RefreshQuality quality;
+    if (!takeFrame(quality))
+      continue;
+
+    xSemaphoreTake(epaper_panel_semaphore, portMAX_DELAY);
+    if (flushFrame(quality)) {
+      // Wait for the waveform to finish. Frames published in the meantime
+      // collapse into the newest one.
+      xSemaphoreTake(epaper_panel_semaphore, portMAX_DELAY);
+      accountRefresh();
+    }
+    xSemaphoreGive(epaper_panel_semaphore);
+  }
+}
+
+bool Adafruit_SSD1680::onRefreshDoneFromISR() {
+  refresh_end_us = esp_timer_get_time();
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  xSemaphoreGiveFromISR(epaper_panel_semaphore, &xHigherPriorityTaskWoken);
+  return xHigherPriorityTaskWoken == pdTRUE;
+}
+
+void Adafruit_SSD1680::applyLutProfile(LutProfile profile) {
+  if (profile == active_lut)
+    return;
+
+  const uint8_t *lut = epd_lut_profiles[profile];
+  if (lut) {
+    epaper_panel_set_custom_lut(panel_handle, (uint8_t *)lut, EPD_LUT_SIZE);
+  } else {
+    // Re-running the init sequence drops the custom LUT so the controller
+    // loads its OTP waveform again
+    esp_lcd_panel_init(panel_handle);
+  }
+  active_lut = profile;
+}
+
+void Adafruit_SSD1680::accountRefresh() {
+  int64_t duration_us = refresh_end_us - refresh_start_us;
+  if (duration_us < 0)
+    return;
+
+  xSemaphoreTake(frame_mutex, portMAX_DELAY);
+  RefreshTiming &timing = stats.timing[refresh_lut];
+  timing.count++;
+  timing.last_ms = duration_us / 1000;
+  timing.total_us += duration_us;
+  xSemaphoreGive(frame_mutex);
+  ESP_LOGD(TAG, "Refresh with LUT profile %d took %lu ms", refresh_lut,
+           timing.last_ms);
+}
+
+bool Adafruit_SSD1680::flushFrame(RefreshQuality quality) {
+  bool partial = (quality != REFRESH_CLEAN) && panel_valid;
+  bool cleanup = false;
 
   if (partial) {
-    // 1. Write to Current RAM (0x24) - partial mode
+    // A partial refresh of an unchanged frame would only cost SPI time and a
+    // waveform cycle, so drop it before touching the panel. Without a shadow
+    // frame only frames nothing was drawn into are dropped.
+    if (shadow_valid) {
+      trimWindowToShadow();
+    }
+    if (flush_window.empty()) {
+      xSemaphoreTake(frame_mutex, portMAX_DELAY);
+      stats.skipped_frames++;
+      xSemaphoreGive(frame_mutex);
+      ESP_LOGD(TAG, "Frame unchanged, refresh skipped");
+      return false;
+    }
+
+    if (refresh_policy.wantsFullRefresh(quality)) {
+      ESP_LOGI(TAG, "Ghosting cleanup after %lu partial refreshes",
+               refresh_policy.getPartialCount(quality));
+      partial = false;
+      cleanup = true;
+    } else {
+      refresh_policy.recordPartial(
+          quality, shadow_valid ? shadow_buffer : nullptr, front_buffer,
+          EPD_ROW_BYTES, flush_window.x0, flush_window.y0, flush_window.x1,
+          flush_window.y1);
+    }
+  }
+
+  if (!partial) {
+    refresh_lut = LUT_PROFILE_CLEAN;
+  } else if (quality == REFRESH_BALANCED) {
+    refresh_lut = LUT_PROFILE_BALANCED;
+  } else {
+    refresh_lut = LUT_PROFILE_FAST;
+  }
+  applyLutProfile(refresh_lut);
+
+  // Bytes clocked into panel RAM. In full mode the driver writes both RAMs.
+  size_t sent;
+  size_t full_cost;
+  if (partial) {
+    // 1. Write flush window to Current RAM (0x24) - partial mode
+    int16_t x_start, cols;
+    const uint8_t *data = prepareFlushWindow(x_start, cols);
     epaper_panel_set_refresh_mode(panel_handle, false);
-    esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, EPD_WIDTH, EPD_HEIGHT,
-                              buffer);
+    size_t window = uploadWindow(data, x_start, cols);
 
     // 2. Refresh Display
+    refresh_start_us = esp_timer_get_time();
     epaper_panel_refresh_screen(panel_handle);
 
-    // 3. Write to Previous RAM (0x26) - full mode (writes both)
+    // 3. Write flush window to Previous RAM (0x26) - full mode (writes both)
     // This ensures 0x26 matches the new state for the next comparison
     epaper_panel_set_refresh_mode(panel_handle, true);
-    esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, EPD_WIDTH, EPD_HEIGHT,
-                              buffer);
+    uploadWindow(data, x_start, cols);
+
+    sent = window * 3;
+    full_cost = buffer_size * 3;
   } else {
     epaper_panel_set_refresh_mode(panel_handle, true); // Full
+    buffers_leased = true;
     esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, EPD_WIDTH, EPD_HEIGHT,
-                              buffer);
+                              front_buffer);
+    refresh_start_us = esp_timer_get_time();
     epaper_panel_refresh_screen(panel_handle);
+
+    sent = buffer_size * 2;
+    full_cost = sent;
   }
+  if (!partial) {
+    refresh_policy.recordFull();
+    panel_valid = true;
+  }
+  updateShadow(!partial);
+  flush_window.reset();
+
+  xSemaphoreTake(frame_mutex, portMAX_DELAY);
+  stats.frames++;
+  if (!partial) {
+    stats.full_refreshes++;
+  }
+  if (cleanup) {
+    stats.cleanups++;
+  }
+  stats.last_bytes_sent = sent;
+  stats.last_bytes_saved = full_cost - sent;
+  stats.total_bytes_sent += sent;
+  stats.total_bytes_saved += stats.last_bytes_saved;
+  xSemaphoreGive(frame_mutex);
+  ESP_LOGD(TAG, "Frame %lu: sent %u bytes, saved %u bytes", stats.frames,
+           (unsigned)sent, (unsigned)(full_cost - sent));
+  return true;
 }
 
 void Adafruit_SSD1680::printRightAligned(int16_t x, int16_t y,
@@ -131,10 +755,8 @@ DisplayManager::~DisplayManager() {
 
 bool DisplayManager::event_callback(const esp_lcd_panel_handle_t handle,
                                     const void *edata, void *user_data) {
-  SemaphoreHandle_t *semaphore_ptr = (SemaphoreHandle_t *)user_data;
-  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-  xSemaphoreGiveFromISR(*semaphore_ptr, &xHigherPriorityTaskWoken);
-  return xHigherPriorityTaskWoken == pdTRUE;
+  Adafruit_SSD1680 *display = (Adafruit_SSD1680 *)user_data;
+  return display->onRefreshDoneFromISR();
 }
 
 esp_err_t DisplayManager::init() {
@@ -178,7 +800,7 @@ esp_err_t DisplayManager::init() {
   ESP_LOGI(TAG, "Creating SSD1680 panel...");
   esp_lcd_ssd1680_config_t epaper_ssd1680_config = {
       .busy_gpio_num = EXAMPLE_PIN_NUM_EPD_BUSY,
-      .non_copy_mode = false,
+      .non_copy_mode = true, // Front/window buffers are sent in place
   };
   esp_lcd_panel_dev_config_t panel_config = {};
   panel_config.reset_gpio_num = EXAMPLE_PIN_NUM_EPD_RST;
@@ -207,16 +829,17 @@ esp_err_t DisplayManager::init() {
   epaper_panel_semaphore = xSemaphoreCreateBinary();
   xSemaphoreGive(epaper_panel_semaphore);
 
+  // --- Initialize GFX
+  display = new Adafruit_SSD1680(EPD_WIDTH, EPD_HEIGHT, io_handle,
+                                 panel_handle, epaper_panel_semaphore);
+
   // --- Register callback
   epaper_panel_callbacks_t cbs = {
       .on_epaper_refresh_done = event_callback,
   };
-  epaper_panel_register_event_callbacks(panel_handle, &cbs,
-                                        &epaper_panel_semaphore);
+  epaper_panel_register_event_callbacks(panel_handle, &cbs, display);
 
-  // --- Initialize GFX
-  display = new Adafruit_SSD1680(EPD_WIDTH, EPD_HEIGHT, panel_handle,
-                                 epaper_panel_semaphore);
+  display->start();
 
   return ESP_OK;
 }
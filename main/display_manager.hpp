@@ -7,6 +7,10 @@
 #include "esp_lcd_panel_vendor.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "epd_luts.hpp"
+#include "glyph_cache.hpp"
+#include "refresh_policy.hpp"
 
 extern "C" {
 #include "esp_lcd_panel_ssd1680.h"
@@ -36,29 +40,309 @@ extern "C" {
 #define GFX_BLACK 0
 #define GFX_WHITE 1
 
+// Bytes per panel RAM row (8 pixels per byte)
+#define EPD_ROW_BYTES (EPD_WIDTH / 8)
+
+/**
+ * @brief Measured waveform durations of one LUT profile
+ */
+struct RefreshTiming {
+  uint32_t count;
+  uint32_t last_ms;
+  uint64_t total_us;
+};
+
+/**
+ * @brief Transfer statistics for panel uploads
+ */
+struct DisplayStats {
+  uint32_t frames;           // Panel uploads performed
+  uint32_t full_refreshes;   // Uploads done as full refresh
+  uint32_t cleanups;         // Full refreshes forced by the refresh policy
+  uint32_t skipped_frames;   // Published frames with no pixel change
+  uint32_t coalesced_frames; // Frames replaced by a newer one before upload
+  uint32_t last_bytes_sent;  // Bytes sent to panel RAM in the last frame
+  uint32_t last_bytes_saved; // Bytes skipped by windowing in the last frame
+  uint64_t total_bytes_sent;
+  uint64_t total_bytes_saved;
+  RefreshTiming timing[LUT_PROFILE_COUNT]; // Indexed by LutProfile
+};
+
+/**
+ * @brief Byte-aligned window in panel coordinates.
+ *
+ * x is in byte columns, y in rows, both inclusive. Empty when x0 > x1.
+ */
+struct DirtyWindow {
+  int16_t x0, y0, x1, y1;
+
+  void reset() {
+    x0 = EPD_ROW_BYTES;
+    y0 = EPD_HEIGHT;
+    x1 = -1;
+    y1 = -1;
+  }
+  bool empty() const { return x0 > x1; }
+  inline void mark(int16_t col, int16_t row) {
+    if (col < x0)
+      x0 = col;
+    if (col > x1)
+      x1 = col;
+    if (row < y0)
+      y0 = row;
+    if (row > y1)
+      y1 = row;
+  }
+  void merge(const DirtyWindow &other) {
+    if (!other.empty()) {
+      mark(other.x0, other.y0);
+      mark(other.x1, other.y1);
+    }
+  }
+};
+
 /**
  * @brief Adafruit GFX implementation for SSD1680 e-Paper display
+ *
+ * Drawing goes to a back buffer owned by the caller's task. display()
+ * publishes it to a flush task that owns the panel, so the caller never
+ * waits for SPI transfers or a waveform. Frames published while the panel
+ * is busy are coalesced and only the newest one is shown.
  */
 class Adafruit_SSD1680 : public Adafruit_GFX {
 public:
-  Adafruit_SSD1680(int16_t w, int16_t h, esp_lcd_panel_handle_t handle,
-                   SemaphoreHandle_t semaphore);
+  Adafruit_SSD1680(int16_t w, int16_t h, esp_lcd_panel_io_handle_t io,
+                   esp_lcd_panel_handle_t handle, SemaphoreHandle_t semaphore);
   ~Adafruit_SSD1680();
 
+  /**
+   * @brief Start the flush task that uploads published frames
+   */
+  void start();
+
   void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h,
+                     uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w,
+                     uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  using Adafruit_GFX::write;
+  size_t write(uint8_t c) override;
   void clearBuffer();
-  void display(bool partial = false);
+
+  /**
+   * @brief Allocate a framebuffer sized layer for saveLayer/loadLayer
+   * @param external Prefer PSRAM, falling back to internal RAM
+   * @return Layer buffer, or nullptr if out of memory. Release with free().
+   */
+  uint8_t *allocLayer(bool external = false);
+
+  /**
+   * @brief Copy the back buffer into a layer
+   */
+  void saveLayer(uint8_t *layer);
+
+  /**
+   * @brief Replace the back buffer with a layer
+   *
+   * Only bytes that differ are written and marked dirty, so restoring a
+   * background over a similar frame keeps the dirty window small.
+   */
+  void loadLayer(const uint8_t *layer);
+
+  /**
+   * @brief Restore a logical rectangle of the back buffer from a layer
+   *
+   * Used to erase a widget's previous content without touching its
+   * neighbours. Only changed bytes are marked dirty.
+   */
+  void loadLayerRect(const uint8_t *layer, int16_t x, int16_t y, int16_t w,
+                     int16_t h);
+
+  /**
+   * @brief Draw into a layer instead of the back buffer until endLayer()
+   *
+   * Used to prerender a screen ahead of time. Holds the frame lock like
+   * beginFrame(), so the flush task waits if it wants a frame meanwhile.
+   */
+  void beginLayer(uint8_t *layer);
+
+  /**
+   * @brief Return drawing to the back buffer
+   */
+  void endLayer();
+
+  /**
+   * @brief Check whether a published frame still waits for the flush task
+   */
+  bool framePending();
+
+  /**
+   * @brief Lock the back buffer before rendering a frame
+   *
+   * Keeps the flush task from copying a half-drawn frame. Released by
+   * display().
+   */
+  void beginFrame();
+
+  /**
+   * @brief Publish the back buffer to the flush task and return immediately
+   * @param quality Refresh quality the screen needs. The refresh policy
+   * decides between partial and full refresh; the cleanest of coalesced
+   * requests wins.
+   */
+  void display(RefreshQuality quality = REFRESH_FAST);
+
+  /**
+   * @brief Make the next published frame a full refresh
+   */
+  void requestCleanRefresh();
 
   /**
    * @brief Print text aligned to the right of the specified X coordinate
    */
   void printRightAligned(int16_t x, int16_t y, const char *str);
 
+  /**
+   * @brief Get a snapshot of panel transfer statistics
+   */
+  DisplayStats getStats();
+
+  /**
+   * @brief Refresh-done notification from the panel busy interrupt
+   * @return true if a higher priority task was woken
+   */
+  bool onRefreshDoneFromISR();
+
 private:
+  esp_lcd_panel_io_handle_t io_handle;
   esp_lcd_panel_handle_t panel_handle;
   SemaphoreHandle_t epaper_panel_semaphore;
   uint8_t *buffer;
   size_t buffer_size;
+
+  // Changes in the back buffer since it was last copied to the front buffer
+  DirtyWindow dirty;
+
+  // Back buffer and its changes while drawing into a layer
+  uint8_t *layer_saved_buffer;
+  DirtyWindow layer_saved_dirty;
+
+  // Back buffer hand-off to the flush task. frame_mutex guards buffer,
+  // dirty, the frame_* request fields and stats.
+  SemaphoreHandle_t frame_mutex;
+  TaskHandle_t flush_task_handle;
+  bool frame_locked;
+  bool frame_pending;
+  bool clean_requested;
+  RefreshQuality frame_quality;
+
+  // Frame being uploaded, owned by the flush task
+  uint8_t *front_buffer;
+  DirtyWindow flush_window;
+
+  // Packed copy of the flush window for non full-width uploads
+  uint8_t *window_buffer;
+
+  // The panel runs in non-copy mode, so the SPI driver reads front_buffer
+  // and window_buffer directly. They stay leased to it from the first
+  // upload of a frame until fenceTransfers() has drained the SPI queue.
+  bool buffers_leased;
+  void fenceTransfers();
+
+  // Copy of the frame currently in panel RAM, used to drop redundant
+  // refreshes. Only valid after the first upload.
+  uint8_t *shadow_buffer;
+  bool shadow_valid;
+
+  // Panel RAM holds a frame, so partial refreshes can follow. Set by the
+  // first full refresh, with or without a shadow buffer.
+  bool panel_valid;
+
+  DisplayStats stats;
+
+  static void flushTaskEntry(void *param);
+  void flushLoop();
+
+  // Full vs partial decisions, used by the flush task only
+  RefreshPolicy refresh_policy;
+
+  // Waveform currently loaded in the controller and timing of the refresh
+  // in flight
+  LutProfile active_lut;
+  LutProfile refresh_lut;
+  int64_t refresh_start_us;
+  volatile int64_t refresh_end_us;
+
+  void applyLutProfile(LutProfile profile);
+  void accountRefresh();
+
+  // Copy a published frame into the front buffer, returns false if none
+  bool takeFrame(RefreshQuality &quality);
+
+  // Upload and refresh the front buffer, returns false if it was skipped
+  bool flushFrame(RefreshQuality quality);
+
+  // Shrink the flush window to bytes that differ from the shadow frame
+  void trimWindowToShadow();
+  void updateShadow(bool full);
+
+  // Glyphs of custom fonts, pre-rotated for the byte blitter
+  GlyphCache glyph_cache;
+
+  // Map a logical rectangle to panel coordinates for the current rotation
+  inline void mapRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t &px,
+                      int16_t &py, int16_t &pw, int16_t &ph) const {
+    // Rotation 3 is the UI landscape mode, check it first
+    if (rotation == 3) {
+      px = y;
+      py = HEIGHT - x - w;
+      pw = h;
+      ph = w;
+      return;
+    }
+    switch (rotation) {
+    case 1:
+      px = WIDTH - y - h;
+      py = x;
+      pw = h;
+      ph = w;
+      break;
+    case 2:
+      px = WIDTH - x - w;
+      py = HEIGHT - y - h;
+      pw = w;
+      ph = h;
+      break;
+    default:
+      px = x;
+      py = y;
+      pw = w;
+      ph = h;
+      break;
+    }
+  }
+
+  // Blit a pre-rotated glyph whose panel bounding box starts at (px, py).
+  // Returns false if the glyph is not fully on the panel.
+  bool blitGlyph(const CachedGlyph &glyph, int16_t px, int16_t py,
+                 uint16_t color);
+
+  // Normalize and clip a logical rectangle, false if nothing is left
+  bool clipRect(int16_t &x, int16_t &y, int16_t &w, int16_t &h) const;
+
+  // Fill a clipped rectangle given in panel coordinates, byte at a time
+  void fillPanelRect(int16_t px, int16_t py, int16_t pw, int16_t ph,
+                     uint16_t color);
+
+  // Locate the flush window in the front buffer, packing it into
+  // window_buffer unless it spans full rows
+  const uint8_t *prepareFlushWindow(int16_t &x_start, int16_t &cols);
+
+  // Send a prepared window to panel RAM, returns bytes sent
+  size_t uploadWindow(const uint8_t *data, int16_t x_start, int16_t cols);
 };
 
 /**
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Waveform LUT: 153 bytes of VS/TP/RP/FR/XON data followed by EOPT, VGH,
+// VSH1, VSH2, VSL and VCOM, as expected by epaper_panel_set_custom_lut
+#define EPD_LUT_SIZE 159
+
+/**
+ * @brief Waveform profiles selectable per refresh
+ */
+enum LutProfile {
+  LUT_PROFILE_FAST,     // Single short phase, menu navigation and the clock
+  LUT_PROFILE_BALANCED, // Longer partial waveform for reader pages
+  LUT_PROFILE_CLEAN,    // Panel OTP waveform, used for full refreshes
+  LUT_PROFILE_COUNT
+};
+
+// Partial waveform with a single 5 frame drive phase. Only black<->white
+// transitions are driven (LUT0 = B->W, LUT1 = W->B), unchanged pixels float.
+static const uint8_t epd_lut_fast[EPD_LUT_SIZE] = {
+    // VS L0..L4, 12 groups each
+    0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x40, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // TPA, TPB, SRAB, TPC, TPD, SRCD, RP for groups 0..11
+    0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    // FR (6), XON (3)
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x00, 0x00, 0x00,
+    // EOPT, VGH, VSH1, VSH2, VSL, VCOM
+    0x22, 0x17, 0x41, 0xB0, 0x32, 0x36};
+
+// Vendor partial waveform: a 10 frame drive phase repeated twice plus a
+// settle phase. Leaves less ghosting on dense text.
+static const uint8_t epd_lut_balanced[EPD_LUT_SIZE] = {
+    // VS L0..L4, 12 groups each
+    0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x40, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // TPA, TPB, SRAB, TPC, TPD, SRCD, RP for groups 0..11
+    0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, //
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+    // FR (6), XON (3)
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x00, 0x00, 0x00,
+    // EOPT, VGH, VSH1, VSH2, VSL, VCOM
+    0x22, 0x17, 0x41, 0xB0, 0x32, 0x36};
+
+// Indexed by LutProfile. nullptr selects the waveform stored in panel OTP.
+static const uint8_t *const epd_lut_profiles[LUT_PROFILE_COUNT] = {
+    epd_lut_fast, epd_lut_balanced, nullptr};
@@ -0,0 +1,102 @@
+#include "glyph_cache.hpp"
+#include "esp_log.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "GlyphCache";
+
+GlyphCache::GlyphCache() : hits(0), misses(0) {
+  memset(slots, 0, sizeof(slots));
+}
+
+GlyphCache::~GlyphCache() {
+  for (int i = 0; i < GLYPH_CACHE_SLOTS; i++) {
+    if (slots[i].bits) {
+      free(slots[i].bits);
+    }
+  }
+}
+
+const CachedGlyph *GlyphCache::get(const GFXfont *font, uint16_t c,
+                                   uint8_t rotation) {
+  uintptr_t key = ((uintptr_t)font >> 2) ^ (c * 31u) ^ (rotation * 7u);
+  CachedGlyph &slot = slots[key & (GLYPH_CACHE_SLOTS - 1)];
+
+  if (slot.font == font && slot.code == c && slot.rotation == rotation) {
+    hits++;
+    return slot.bits ? &slot : nullptr;
+  }
+
+  misses++;
+  if (!rasterize(slot, font, c, rotation)) {
+    slot.font = nullptr;
+    return nullptr;
+  }
+  return &slot;
+}
+
+bool GlyphCache::rasterize(CachedGlyph &slot, const GFXfont *font, uint16_t c,
+                           uint8_t rotation) {
+  const GFXglyph *glyph = font->glyph + (c - font->first);
+  const uint8_t *bitmap = font->bitmap + glyph->bitmapOffset;
+  uint8_t w = glyph->width;
+  uint8_t h = glyph->height;
+  if (w == 0 || h == 0)
+    return false;
+
+  // Rotations 1 and 3 swap the glyph axes on the panel
+  bool swap = (rotation & 1);
+  uint8_t cols = swap ? h : w;
+  uint8_t rows = swap ? w : h;
+  uint8_t stride = (cols + 7) / 8;
+  size_t size = (size_t)stride * rows;
+
+  if (size > slot.capacity) {
+    uint8_t *bits = (uint8_t *)realloc(slot.bits, size);
+    if (!bits) {
+      ESP_LOGE(TAG, "Failed to allocate %u bytes for glyph", (unsigned)size);
+      return false;
+    }
+    slot.bits = bits;
+    slot.capacity = size;
+  }
+  memset(slot.bits, 0, size);
+
+  // Glyph bits are packed row after row with no padding
+  uint16_t bit = 0;
+  for (uint8_t yy = 0; yy < h; yy++) {
+    for (uint8_t xx = 0; xx < w; xx++, bit++) {
+      if (!(bitmap[bit >> 3] & (0x80 >> (bit & 7))))
+        continue;
+
+      uint8_t col, row;
+      switch (rotation) {
+      case 1:
+        col = h - 1 - yy;
+        row = xx;
+        break;
+      case 2:
+        col = w - 1 - xx;
+        row = h - 1 - yy;
+        break;
+      case 3:
+        col = yy;
+        row = w - 1 - xx;
+        break;
+      default:
+        col = xx;
+        row = yy;
+        break;
+      }
+      slot.bits[row * stride + (col >> 3)] |= 0x80 >> (col & 7);
+    }
+  }
+
+  slot.font = font;
+  slot.code = c;
+  slot.rotation = rotation;
+  slot.cols = cols;
+  slot.rows = rows;
+  slot.stride = stride;
+  return true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "gfxfont.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Number of direct-mapped cache slots (power of two)
+#define GLYPH_CACHE_SLOTS 64
+
+/**
+ * @brief GFXfont glyph pre-rotated to panel orientation.
+ *
+ * Bits are stored MSB first with every panel row padded to whole bytes, so
+ * a row can be shifted straight into the 1bpp framebuffer.
+ */
+struct CachedGlyph {
+  const GFXfont *font;
+  uint16_t code;
+  uint8_t rotation;
+  uint8_t cols;   // Width in panel pixels
+  uint8_t rows;   // Height in panel rows
+  uint8_t stride; // Bytes per row
+  uint8_t *bits;
+  size_t capacity;
+};
+
+/**
+ * @brief Small cache of pre-rotated glyphs keyed by font, code and rotation
+ */
+class GlyphCache {
+public:
+  GlyphCache();
+  ~GlyphCache();
+
+  /**
+   * @brief Look up a glyph, rasterizing it on a miss
+   * @param font Font the glyph belongs to
+   * @param c Character code, must be within the font range
+   * @param rotation Adafruit_GFX rotation (0-3)
+   * @return Cached glyph, or nullptr if it has no bitmap or allocation failed
+   */
+  const CachedGlyph *get(const GFXfont *font, uint16_t c, uint8_t rotation);
+
+  uint32_t getHits() const { return hits; }
+  uint32_t getMisses() const { return misses; }
+
+private:
+  CachedGlyph slots[GLYPH_CACHE_SLOTS];
+  uint32_t hits;
+  uint32_t misses;
+
+  bool rasterize(CachedGlyph &slot, const GFXfont *font, uint16_t c,
+                 uint8_t rotation);
+};
@@ -0,0 +1,122 @@
+#include "input_gestures.hpp"
+#include "esp_log.h"
+
+static const char *TAG = "Gestures";
+
+GestureRecognizer::GestureRecognizer(const GestureTimings &timings)
+    : timings(timings), state(IDLE), second_press(false), press_time(0),
+      release_time(0), next_repeat(0), long_hold_fired(false), head(0),
+      count(0) {}
+
+void GestureRecognizer::setTimings(const GestureTimings &new_timings) {
+  timings = new_timings;
+}
+
+void GestureRecognizer::emit(GestureType type, int64_t time_us) {
+  if (count == QUEUE_LEN) {
+    ESP_LOGW(TAG, "Gesture queue full, dropping oldest");
+    head = (head + 1) % QUEUE_LEN;
+    count--;
+  }
+  queue[(head + count) % QUEUE_LEN] = {type, time_us};
+  count++;
+}
+
+bool GestureRecognizer::nextGesture(Gesture &gesture) {
+  if (count == 0)
+    return false;
+  gesture = queue[head];
+  head = (head + 1) % QUEUE_LEN;
+  count--;
+  return true;
+}
+
+void GestureRecognizer::onEdge(bool pressed, int64_t time_us) {
+  // Timeouts that expired before this edge happened come first
+  poll(time_us);
+
+  if (pressed) {
+    if (state == PRESSED || state == HELD)
+      return; // Duplicate edge
+    second_press = (state == WAIT_NEXT);
+    state = PRESSED;
+    press_time = time_us;
+    long_hold_fired = false;
+    return;
+  }
+
+  if (state == HELD) {
+    // Holds consume the press
+    state = IDLE;
+  } else if (state == PRESSED) {
+    if (second_press) {
+      emit(GESTURE_DOUBLE_CLICK, time_us);
+      state = IDLE;
+    } else if (timings.double_click_us == 0) {
+      emit(GESTURE_CLICK, time_us);
+      state = IDLE;
+    } else {
+      release_time = time_us;
+      state = WAIT_NEXT;
+    }
+  }
+  second_press = false;
+}
+
+void GestureRecognizer::poll(int64_t now_us) {
+  int64_t deadline;
+  while ((deadline = nextDeadline()) >= 0 && deadline <= now_us) {
+    switch (state) {
+    case WAIT_NEXT:
+      emit(GESTURE_CLICK, deadline);
+      state = IDLE;
+      break;
+    case PRESSED:
+      if (second_press) {
+        // The second press turned into a hold, report the pending click
+        emit(GESTURE_CLICK, deadline);
+        second_press = false;
+      }
+      emit(GESTURE_HOLD, deadline);
+      state = HELD;
+      next_repeat = deadline + timings.repeat_us;
+      break;
+    case HELD:
+      if (timings.long_hold_us > 0 && !long_hold_fired &&
+          deadline == press_time + timings.long_hold_us) {
+        emit(GESTURE_LONG_HOLD, deadline);
+        long_hold_fired = true;
+      } else {
+        emit(GESTURE_REPEAT, deadline);
+        next_repeat += timings.repeat_us;
+      }
+      break;
+    default:
+      return;
+    }
+  }
+}
+
+int64_t GestureRecognizer::nextDeadline() const {
+  switch (state) {
+  case WAIT_NEXT:
+    return release_time + timings.double_click_us;
+  case PRESSED:
+    return (timings.hold_us > 0) ? press_time + timings.hold_us : -1;
+  case HELD: {
+    int64_t next = -1;
+    if (timings.repeat_us > 0) {
+      next = next_repeat;
+    }
+    if (timings.long_hold_us > 0 && !long_hold_fired) {
+      int64_t long_hold = press_time + timings.long_hold_us;
+      if (next < 0 || long_hold <= next) {
+        next = long_hold;
+      }
+    }
+    return next;
+  }
+  default:
+    return -1;
+  }
+}
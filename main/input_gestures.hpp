@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+
+enum GestureType {
+  GESTURE_CLICK,
+  GESTURE_DOUBLE_CLICK,
+  GESTURE_HOLD,      // Held for hold_us
+  GESTURE_REPEAT,    // Every repeat_us while still held after a hold
+  GESTURE_LONG_HOLD, // Held for long_hold_us
+};
+
+/**
+ * @brief Gesture timings, a zero time disables that gesture
+ *
+ * With double clicks disabled a click is reported on release, otherwise
+ * only after the double click window passes without a second press.
+ */
+struct GestureTimings {
+  int64_t double_click_us;
+  int64_t hold_us;
+  int64_t long_hold_us;
+  int64_t repeat_us;
+};
+
+struct Gesture {
+  GestureType type;
+  int64_t time_us; // When the gesture was recognized
+};
+
+/**
+ * @brief Turns timestamped button edges into gestures
+ *
+ * Edges carry the time they happened at the source, so gestures are
+ * classified correctly even if the edges are processed late. Timeouts are
+ * driven by poll(), call it at nextDeadline().
+ */
+class GestureRecognizer {
+public:
+  explicit GestureRecognizer(const GestureTimings &timings);
+
+  void setTimings(const GestureTimings &timings);
+
+  // Feed a debounced edge
+  void onEdge(bool pressed, int64_t time_us);
+
+  // Fire gestures whose deadline is at or before now_us
+  void poll(int64_t now_us);
+
+  // Time of the next pending timeout, or -1 if none
+  int64_t nextDeadline() const;
+
+  // Take the oldest recognized gesture
+  bool nextGesture(Gesture &gesture);
+
+private:
+  enum State {
+    IDLE,
+    PRESSED,   // Down, no hold reported yet
+    HELD,      // Down, hold reported
+    WAIT_NEXT, // Released after a click, waiting for a second press
+  };
+
+  GestureTimings timings;
+  State state;
+  bool second_press;     // Current press follows a click in the window
+  int64_t press_time;    // Start of the current press
+  int64_t release_time;  // End of the last click
+  int64_t next_repeat;   // Next repeat, valid while HELD
+  bool long_hold_fired;
+
+  // Small ring of recognized gestures
+  static const int QUEUE_LEN = 4;
+  Gesture queue[QUEUE_LEN];
+  uint8_t head;
+  uint8_t count;
+
+  void emit(GestureType type, int64_t time_us);
+};
@@ -1,5 +1,7 @@
 #include "battery_manager.hpp"
+#include "book_bench.hpp"
 #include "common_data.hpp"
+#include "display_bench.hpp"
 #include "display_manager.hpp"
 #include "esp_log.h"
 #include "esp_timer.h"
@@ -43,6 +45,10 @@ extern "C" void app_main(void) {
     return;
   }
 
+#if DISPLAY_RUN_BENCHMARK
+  display_benchmark(display);
+#endif
+
   // Initialize Touch
   static TouchManager touchManager;
   if (touchManager.init() == ESP_OK) {
@@ -63,6 +69,10 @@ extern "C" void app_main(void) {
   static StorageManager storageManager;
   storageManager.mount();
 
+#if BOOK_RUN_BENCHMARK
+  book_benchmark();
+#endif
+
   // Initialize I2C Library
   ESP_ERROR_CHECK(i2cdev_init());
 
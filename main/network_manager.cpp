@@ -1,4 +1,6 @@
 #include "network_manager.hpp"
+#include "common_data.hpp"
+#include "data_bus.hpp"
 #include "esp_event.h"
 #include "esp_log.h"
 #include "esp_netif.h"
@@ -29,6 +31,8 @@ void NetworkManager::wifi_event_handler(void *arg, esp_event_base_t event_base,
   if (event_id == WIFI_EVENT_STA_START) {
     esp_wifi_connect();
   } else if (event_id == WIFI_EVENT_STA_DISCONNECTED) {
+    global_data.setWifiConnected(false);
+    data_bus.publish(TOPIC_WIFI, 0);
     esp_wifi_connect();
     ESP_LOGI(TAG, "retrying to connect to the AP");
   }
@@ -39,6 +43,8 @@ void NetworkManager::ip_event_handler(void *arg, esp_event_base_t event_base,
   if (event_id == IP_EVENT_STA_GOT_IP) {
     ip_event_got_ip_t *event = (ip_event_got_ip_t *)event_data;
     ESP_LOGI(TAG, "got ip:" IPSTR, IP2STR(&event->ip_info.ip));
+    global_data.setWifiConnected(true);
+    data_bus.publish(TOPIC_WIFI, 1);
     xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
   }
 }
@@ -128,6 +134,8 @@ void NetworkManager::deinit() {
     vEventGroupDelete(s_wifi_event_group);
     connected = false;
     time_synced = false;
+    global_data.setWifiConnected(false);
+    data_bus.publish(TOPIC_WIFI, 0);
     ESP_LOGI(TAG, "Network deinitialized.");
   }
 }
@@ -0,0 +1,104 @@
+#include "page_cache.hpp"
+#include "esp_log.h"
+#include <stdlib.h>
+
+static const char *TAG = "PageCache";
+
+// Log the hit rate every this many page turns
+#define PAGE_CACHE_LOG_INTERVAL 20
+
+static bool samePosition(const BookPosition &a, const BookPosition &b) {
+  return a.page == b.page && a.pages == b.pages &&
+         a.page_exact == b.page_exact && a.pages_exact == b.pages_exact;
+}
+
+PageCache::PageCache() : stats{} {
+  for (int i = 0; i < PAGE_CACHE_SLOTS; i++) {
+    slots[i].frame = nullptr;
+    slots[i].valid = false;
+  }
+}
+
+PageCache::~PageCache() {
+  for (int i = 0; i < PAGE_CACHE_SLOTS; i++) {
+    free(slots[i].frame);
+  }
+}
+
+int PageCache::init(Adafruit_SSD1680 *display) {
+  int count = 0;
+  for (int i = 0; i < PAGE_CACHE_SLOTS; i++) {
+    if (!slots[i].frame) {
+      slots[i].frame = display->allocLayer(true);
+    }
+    if (slots[i].frame) {
+      count++;
+    }
+  }
+  ESP_LOGI(TAG, "%d prerender frames", count);
+  return count;
+}
+
+int PageCache::find(uint32_t offset, const BookPosition &pos) const {
+  for (int i = 0; i < PAGE_CACHE_SLOTS; i++) {
+    if (slots[i].valid && slots[i].offset == offset &&
+        samePosition(slots[i].pos, pos)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+const uint8_t *PageCache::lookup(uint32_t offset, const BookPosition &pos) {
+  int i = find(offset, pos);
+  if (i >= 0) {
+    stats.hits++;
+  } else {
+    stats.misses++;
+  }
+
+  uint32_t turns = stats.hits + stats.misses;
+  if (turns % PAGE_CACHE_LOG_INTERVAL == 0) {
+    ESP_LOGI(TAG, "%lu hits, %lu misses (%lu%%), %lu prerendered", stats.hits,
+             stats.misses, stats.hits * 100 / turns, stats.prerenders);
+  }
+  return (i >= 0) ? slots[i].frame : nullptr;
+}
+
+bool PageCache::contains(uint32_t offset, const BookPosition &pos) const {
+  return find(offset, pos) >= 0;
+}
+
+uint8_t *PageCache::prepare(uint32_t offset, const BookPosition &pos,
+                            uint32_t keep_offset) {
+  Slot *target = nullptr;
+  for (int i = 0; i < PAGE_CACHE_SLOTS; i++) {
+    Slot &slot = slots[i];
+    if (!slot.frame) {
+      continue;
+    }
+    // A stale frame of the same page is the best one to overwrite
+    if (!slot.valid || slot.offset == offset) {
+      target = &slot;
+      break;
+    }
+    if (!target && slot.offset != keep_offset) {
+      target = &slot;
+    }
+  }
+  if (!target) {
+    return nullptr;
+  }
+
+  target->valid = true;
+  target->offset = offset;
+  target->pos = pos;
+  stats.prerenders++;
+  return target->frame;
+}
+
+void PageCache::clear() {
+  for (int i = 0; i < PAGE_CACHE_SLOTS; i++) {
+    slots[i].valid = false;
+  }
+}
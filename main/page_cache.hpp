@@ -0,0 +1,77 @@
+#pragma once
+
+#include "book_reader.hpp"
+#include "display_manager.hpp"
+#include <stdint.h>
+
+// Prerendered frames, enough for the pages before and after the current one
+#define PAGE_CACHE_SLOTS 2
+
+/**
+ * @brief Page turn statistics of the prerender cache
+ */
+struct PageCacheStats {
+  uint32_t hits;       // Page turns shown from a prerendered frame
+  uint32_t misses;     // Page turns that had to render the page
+  uint32_t prerenders; // Pages rendered ahead of time
+};
+
+/**
+ * @brief Reader pages prerendered into spare framebuffers
+ *
+ * Frames are keyed by the page offset and the position shown in the footer,
+ * so a frame goes stale on its own once pagination changes the numbers.
+ */
+class PageCache {
+public:
+  PageCache();
+  ~PageCache();
+
+  /**
+   * @brief Allocate the frames, in PSRAM when available
+   * @return Number of frames allocated
+   */
+  int init(Adafruit_SSD1680 *display);
+
+  /**
+   * @brief Find the frame of a page turned to, counting a hit or miss
+   * @return Prerendered frame, nullptr if the page has none
+   */
+  const uint8_t *lookup(uint32_t offset, const BookPosition &pos);
+
+  /**
+   * @brief Check whether a page is prerendered, without counting
+   */
+  bool contains(uint32_t offset, const BookPosition &pos) const;
+
+  /**
+   * @brief Get a frame to prerender a page into
+   *
+   * Takes a frame holding neither the page nor keep_offset, so the other
+   * neighbour of the current page survives. The frame is marked as holding
+   * the page right away, the caller draws it before the next lookup.
+   * @return Frame to draw into, nullptr without frames
+   */
+  uint8_t *prepare(uint32_t offset, const BookPosition &pos,
+                   uint32_t keep_offset);
+
+  /**
+   * @brief Drop all frames, e.g. when another book is opened
+   */
+  void clear();
+
+  PageCacheStats getStats() const { return stats; }
+
+private:
+  struct Slot {
+    uint8_t *frame;
+    bool valid;
+    uint32_t offset;
+    BookPosition pos;
+  };
+
+  Slot slots[PAGE_CACHE_SLOTS];
+  PageCacheStats stats;
+
+  int find(uint32_t offset, const BookPosition &pos) const;
+};
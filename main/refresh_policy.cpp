@@ -0,0 +1,66 @@
+#include "refresh_policy.hpp"
+#include <string.h>
+
+struct RefreshLimits {
+  uint16_t max_partials;    // Partial refreshes between cleanups
+  uint16_t max_tile_flips;  // Average flips per pixel in any tile
+};
+
+// Indexed by RefreshQuality. The clock changes every second, so the fast
+// profile tolerates far more partials than a reader page.
+static const RefreshLimits limits[] = {
+    {600, 48}, // REFRESH_FAST
+    {10, 3},   // REFRESH_BALANCED
+    {0, 0},    // REFRESH_CLEAN
+};
+static_assert(sizeof(limits) / sizeof(limits[0]) == REFRESH_QUALITY_COUNT,
+              "one limit per quality");
+
+static const uint32_t TILE_PIXELS = REFRESH_TILE_BYTES * 8 * REFRESH_TILE_ROWS;
+
+RefreshPolicy::RefreshPolicy() { recordFull(); }
+
+bool RefreshPolicy::wantsFullRefresh(RefreshQuality quality) const {
+  if (quality == REFRESH_CLEAN)
+    return true;
+
+  const RefreshLimits &limit = limits[quality];
+  if (partials_since_full[quality] >= limit.max_partials)
+    return true;
+
+  uint32_t max_flips = limit.max_tile_flips * TILE_PIXELS;
+  for (int r = 0; r < REFRESH_GRID_ROWS; r++) {
+    for (int c = 0; c < REFRESH_GRID_COLS; c++) {
+      if (tile_flips[r][c] >= max_flips)
+        return true;
+    }
+  }
+  return false;
+}
+
+void RefreshPolicy::recordPartial(RefreshQuality quality,
+                                  const uint8_t *old_frame,
+                                  const uint8_t *new_frame, int16_t stride,
+                                  int16_t x0, int16_t y0, int16_t x1,
+                                  int16_t y1) {
+  partials_since_full[quality]++;
+  if (old_frame == nullptr)
+    return;
+
+  for (int16_t row = y0; row <= y1; row++) {
+    const uint8_t *o = old_frame + row * stride;
+    const uint8_t *n = new_frame + row * stride;
+    uint32_t *tiles = tile_flips[row / REFRESH_TILE_ROWS];
+    for (int16_t col = x0; col <= x1; col++) {
+      uint8_t diff = o[col] ^ n[col];
+      if (diff) {
+        tiles[col / REFRESH_TILE_BYTES] += __builtin_popcount(diff);
+      }
+    }
+  }
+}
+
+void RefreshPolicy::recordFull() {
+  memset(partials_since_full, 0, sizeof(partials_since_full));
+  memset(tile_flips, 0, sizeof(tile_flips));
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+
+// Ghosting is tracked on a grid of 32x32 pixel tiles in panel coordinates,
+// sized for the 128x296 panel
+#define REFRESH_TILE_BYTES 4 // Tile width in byte columns
+#define REFRESH_TILE_ROWS 32
+#define REFRESH_GRID_COLS 4
+#define REFRESH_GRID_ROWS 10
+
+/**
+ * @brief Refresh quality a screen asks for
+ *
+ * Ordered from cheapest to cleanest. When several requests are coalesced
+ * into one frame the cleanest one wins.
+ */
+enum RefreshQuality {
+  REFRESH_FAST,     // Partial updates, cleanup only on heavy ghosting
+  REFRESH_BALANCED, // Partial updates with periodic cleanup
+  REFRESH_CLEAN,    // Full refresh now
+  REFRESH_QUALITY_COUNT
+};
+
+/**
+ * @brief Decides when partial updates have left enough ghosting to need a
+ * full refresh
+ */
+class RefreshPolicy {
+public:
+  RefreshPolicy();
+
+  /**
+   * @brief Check whether the next frame should be a full refresh
+   * @param quality Quality requested for the frame
+   */
+  bool wantsFullRefresh(RefreshQuality quality) const;
+
+  /**
+   * @brief Account pixel flips of a partial refresh
+   * @param quality Quality the frame was requested with
+   * @param old_frame Frame previously on the panel, nullptr if unknown.
+   * Without it only the partial refresh is counted, not its pixel flips.
+   * @param new_frame Frame being shown
+   * @param stride Bytes per panel row
+   * @param x0,y0,x1,y1 Changed window, byte columns and rows, inclusive
+   */
+  void recordPartial(RefreshQuality quality, const uint8_t *old_frame, const uint8_t *new_frame,
+                     int16_t stride, int16_t x0, int16_t y0, int16_t x1,
+                     int16_t y1);
+
+  /**
+   * @brief Reset ghosting state after a full refresh
+   */
+  void recordFull();
+
+  uint32_t getPartialCount(RefreshQuality quality) const {
+    return partials_since_full[quality];
+  }
+
+private:
+  // Counted per quality, so the clock's many fast partials do not use up
+  // the few a reader page allows. Pixel flips are physical ghosting and
+  // are shared.
+  uint32_t partials_since_full[REFRESH_QUALITY_COUNT];
+  uint32_t tile_flips[REFRESH_GRID_ROWS][REFRESH_GRID_COLS];
+};
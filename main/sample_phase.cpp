@@ -0,0 +1,67 @@
+#include "sample_phase.hpp"
+#include "esp_log.h"
+
+static const char *TAG = "SamplePhase";
+
+// Delay after the expected completion before checking, covers tick jitter
+#define PHASE_MARGIN_US 30000
+// Each successful check moves the schedule earlier by period / PHASE_PROBE_DIV
+#define PHASE_PROBE_DIV 500
+// Measured periods further than period / PHASE_MAX_DEVIATION_DIV from the
+// nominal one are ignored
+#define PHASE_MAX_DEVIATION_DIV 20
+
+SamplePhaseTracker::SamplePhaseTracker()
+    : period_us(0), nominal_period_us(0), margin_us(PHASE_MARGIN_US),
+      next_expected_us(0), anchor_us(0), since_anchor(0), is_locked(false),
+      resyncing(false), resyncs(0) {}
+
+void SamplePhaseTracker::reset(int64_t period) {
+  // Keep a learned period if the nominal one did not change
+  if (period != nominal_period_us) {
+    nominal_period_us = period;
+    period_us = period;
+  }
+  is_locked = false;
+  resyncing = false;
+  anchor_us = 0;
+  since_anchor = 0;
+}
+
+void SamplePhaseTracker::onReady(int64_t time_us, bool scheduled) {
+  if (scheduled && locked()) {
+    // Completion happened at or before this check. Probe a little earlier
+    // next time so a fast sensor clock is followed too.
+    since_anchor++;
+    next_expected_us += period_us - period_us / PHASE_PROBE_DIV;
+    return;
+  }
+
+  // Polled: time_us is close to the real completion, use it as anchor
+  if (anchor_us != 0) {
+    since_anchor++;
+    int64_t measured = (time_us - anchor_us) / since_anchor;
+    int64_t deviation = measured - nominal_period_us;
+    if (deviation < 0) {
+      deviation = -deviation;
+    }
+    if (deviation < nominal_period_us / PHASE_MAX_DEVIATION_DIV) {
+      period_us = (period_us * 3 + measured) / 4;
+    }
+    ESP_LOGD(TAG, "Anchored, period %lld us (measured %lld over %lu)",
+             period_us, measured, since_anchor);
+  }
+  anchor_us = time_us;
+  since_anchor = 0;
+  next_expected_us = time_us + period_us;
+  is_locked = true;
+  resyncing = false;
+}
+
+void SamplePhaseTracker::onNotReady() {
+  if (!locked())
+    return;
+  resyncing = true;
+  resyncs++;
+  ESP_LOGD(TAG, "Scheduled check not ready, resyncing (%lu)", resyncs);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Learns when a periodic sensor completes its samples
+ *
+ * The tracker is anchored by polling until data becomes ready. After that
+ * one status check is scheduled just after each expected completion. A
+ * check that finds data ready moves the next one slightly earlier to follow
+ * a sensor clock that runs fast; a check that comes back not ready means
+ * the sensor runs slow, and the caller polls again to re-anchor. The period
+ * is corrected from the time between anchors.
+ */
+class SamplePhaseTracker {
+public:
+  SamplePhaseTracker();
+
+  // Forget the phase, e.g. after measurement was restarted
+  void reset(int64_t period_us);
+
+  // True once a completion time is known and checks can be scheduled
+  bool locked() const { return is_locked && !resyncing; }
+
+  // Time of the next scheduled status check, valid while locked
+  int64_t nextCheckTime() const { return next_expected_us + margin_us; }
+
+  /**
+   * @brief Data was found ready
+   * @param time_us Time of the check
+   * @param scheduled True for a scheduled check while locked, false while
+   * polling to anchor
+   */
+  void onReady(int64_t time_us, bool scheduled);
+
+  // A scheduled check found no data, the caller polls to re-anchor
+  void onNotReady();
+
+  int64_t getPeriod() const { return period_us; }
+  uint32_t getResyncs() const { return resyncs; }
+
+private:
+  int64_t period_us;
+  int64_t nominal_period_us;
+  int64_t margin_us;
+  int64_t next_expected_us;
+  int64_t anchor_us;       // Last polled (precise) completion
+  uint32_t since_anchor;   // Samples since anchor_us
+  bool is_locked;
+  bool resyncing;
+  uint32_t resyncs;
+};
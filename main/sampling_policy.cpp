@@ -0,0 +1,117 @@
+#include "sampling_policy.hpp"
+#include <math.h>
+
+// Minimum span of a trend window
+#define SAMPLING_WINDOW_US (60 * 1000000LL)
+// Time a rate is kept before stepping down to a slower one
+#define SAMPLING_MIN_DWELL_US (120 * 1000000LL)
+
+// CO2 trend thresholds in ppm per minute
+#define SLOPE_FAST 20.0f   // Above: fast sampling
+#define SLOPE_STABLE 5.0f  // Below: room counts as stable
+
+// Battery thresholds in volts
+#define BATTERY_LOW 3.5f      // No fast sampling, single shots when stable
+#define BATTERY_CRITICAL 3.4f // Single shots only, long interval
+
+// Night hours, single shots when stable
+#define NIGHT_START_HOUR 23
+#define NIGHT_END_HOUR 7
+
+// Single shot intervals
+#define SINGLE_SHOT_INTERVAL_MS (5 * 60 * 1000)
+#define SINGLE_SHOT_CRITICAL_INTERVAL_MS (10 * 60 * 1000)
+
+SamplingPolicy::SamplingPolicy()
+    : preference(SAMPLING_AUTO), single_shot_supported(false),
+      window_start_us(0), window_time_sum(0), window_sum(0), window_count(0),
+      prev_average(0),
+      prev_time_us(0), slope_ppm_min(-1.0f), current(SAMPLE_FAST),
+      current_since_us(0) {}
+
+void SamplingPolicy::addSample(uint16_t co2, int64_t time_us) {
+  if (window_count == 0) {
+    window_start_us = time_us;
+    window_time_sum = 0;
+  }
+  window_sum += co2;
+  window_time_sum += time_us - window_start_us;
+  window_count++;
+
+  // A window closes once it spans the minimum time, or right away when
+  // samples are sparse (single shots)
+  bool spanned = (time_us - window_start_us >= SAMPLING_WINDOW_US);
+  bool sparse =
+      (prev_time_us != 0 && time_us - prev_time_us >= SAMPLING_WINDOW_US);
+  if (!spanned && !sparse)
+    return;
+
+  // Compare the window average with the previous one, placed at the mean
+  // sample time of each window
+  float average = (float)window_sum / window_count;
+  int64_t mean_time = window_start_us + window_time_sum / window_count;
+  if (prev_time_us != 0) {
+    float minutes = (mean_time - prev_time_us) / 60e6f;
+    if (minutes > 0) {
+      slope_ppm_min = fabsf(average - prev_average) / minutes;
+    }
+  }
+  prev_average = average;
+  prev_time_us = mean_time;
+  window_sum = 0;
+  window_count = 0;
+}
+
+SamplingDecision SamplingPolicy::decide(float battery_v, int hour,
+                                        int64_t now_us) {
+  SamplingDecision decision = {SAMPLE_FAST, SINGLE_SHOT_INTERVAL_MS};
+
+  switch (preference) {
+  case SAMPLING_FAST:
+    decision.rate = SAMPLE_FAST;
+    break;
+  case SAMPLING_LOW_POWER:
+    decision.rate = SAMPLE_LOW_POWER;
+    break;
+  case SAMPLING_SINGLE_SHOT:
+    decision.rate = SAMPLE_SINGLE_SHOT;
+    break;
+  case SAMPLING_AUTO: {
+    bool night = (hour >= NIGHT_START_HOUR || hour < NIGHT_END_HOUR);
+    bool known = (slope_ppm_min >= 0);
+    bool stable = known && slope_ppm_min < SLOPE_STABLE;
+
+    if (battery_v < BATTERY_CRITICAL) {
+      decision.rate = SAMPLE_SINGLE_SHOT;
+      decision.interval_ms = SINGLE_SHOT_CRITICAL_INTERVAL_MS;
+    } else if (!known) {
+      // Until a trend is known, learn it quickly unless the battery is low
+      decision.rate = (battery_v < BATTERY_LOW) ? SAMPLE_LOW_POWER : SAMPLE_FAST;
+    } else if (slope_ppm_min >= SLOPE_FAST && battery_v >= BATTERY_LOW) {
+      decision.rate = SAMPLE_FAST;
+    } else if (stable && (night || battery_v < BATTERY_LOW)) {
+      decision.rate = SAMPLE_SINGLE_SHOT;
+    } else {
+      decision.rate = SAMPLE_LOW_POWER;
+    }
+
+    // Hold the current rate for a while before slowing down
+    if (decision.rate < current &&
+        now_us - current_since_us < SAMPLING_MIN_DWELL_US &&
+        battery_v >= BATTERY_CRITICAL) {
+      decision.rate = current;
+    }
+    break;
+  }
+  }
+
+  if (decision.rate == SAMPLE_SINGLE_SHOT && !single_shot_supported) {
+    decision.rate = SAMPLE_LOW_POWER;
+  }
+
+  if (decision.rate != current) {
+    current = decision.rate;
+    current_since_us = now_us;
+  }
+  return decision;
+}
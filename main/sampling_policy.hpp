@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Sampling mode requested by the user
+ */
+enum SamplingPreference {
+  SAMPLING_AUTO,        // Chosen by SamplingPolicy
+  SAMPLING_FAST,        // Periodic, 5 s
+  SAMPLING_LOW_POWER,   // Low power periodic, 30 s
+  SAMPLING_SINGLE_SHOT, // On-demand single shots
+};
+
+/**
+ * @brief Sampling rate the sensor should run at
+ *
+ * Ordered from slowest to fastest.
+ */
+enum SamplingRate {
+  SAMPLE_SINGLE_SHOT,
+  SAMPLE_LOW_POWER,
+  SAMPLE_FAST,
+};
+
+struct SamplingDecision {
+  SamplingRate rate;
+  uint32_t interval_ms; // Time between single shots
+};
+
+/**
+ * @brief Picks a measurement mode from CO2 trend, battery and time of day
+ *
+ * The trend is the change of the CO2 average between consecutive windows
+ * of at least SAMPLING_WINDOW_US, which filters out per-sample noise. Fast
+ * sampling is used while CO2 moves quickly, single shots while the room is
+ * stable at night or the battery is low. Slowing down requires the mode to
+ * have been kept for a minimum dwell time, speeding up is immediate.
+ */
+class SamplingPolicy {
+public:
+  SamplingPolicy();
+
+  void setPreference(SamplingPreference value) { preference = value; }
+  SamplingPreference getPreference() const { return preference; }
+
+  // SCD40 has no single shot mode
+  void setSingleShotSupported(bool value) { single_shot_supported = value; }
+
+  // Feed a CO2 sample
+  void addSample(uint16_t co2, int64_t time_us);
+
+  /**
+   * @brief Decide the sampling rate
+   * @param battery_v Battery voltage
+   * @param hour Local hour (0-23)
+   * @param now_us Current time
+   */
+  SamplingDecision decide(float battery_v, int hour, int64_t now_us);
+
+  // Absolute CO2 trend in ppm per minute, negative if unknown
+  float getSlope() const { return slope_ppm_min; }
+
+private:
+  SamplingPreference preference;
+  bool single_shot_supported;
+
+  // Trend windows
+  int64_t window_start_us;
+  int64_t window_time_sum; // Sample times relative to the window start
+  uint32_t window_sum;
+  uint16_t window_count;
+  float prev_average;
+  int64_t prev_time_us;
+  float slope_ppm_min;
+
+  SamplingRate current;
+  int64_t current_since_us;
+};
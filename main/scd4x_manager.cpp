@@ -1,11 +1,40 @@
 #include "scd4x_manager.hpp"
 #include "common_data.hpp"
+#include "data_bus.hpp"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "scd4x_sim.hpp"
 #include <string.h>
+#include <time.h>
 
 static const char *TAG = "Scd4xManager";
 
-Scd4xManager::Scd4xManager() { memset(&dev, 0, sizeof(i2c_dev_t)); }
+// Time the sensor needs after stop_periodic_measurement before it accepts
+// other commands
+#define SCD4X_STOP_DELAY_MS 500
+
+// Sample periods per the datasheet
+#define SCD4X_PERIODIC_MS 5000
+#define SCD4X_LOW_POWER_PERIODIC_MS 30000
+#define SCD4X_SINGLE_SHOT_MS 5000
+
+// Start polling data ready this long before a periodic sample is due,
+// used until the sample phase is known
+#define SCD4X_POLL_LEAD_MS 1000
+// Poll interval while anchoring the sample phase
+#define SCD4X_POLL_MS 50
+
+Scd4xManager::Scd4xManager()
+    : mode(SCD4X_MODE_IDLE), measure_mode(SCD4X_MODE_PERIODIC),
+      serial_valid(false), variant(0), variant_valid(false),
+      asc_enabled(false), asc_valid(false),
+      single_shot_interval_ms(5 * 60 * 1000), shot_pending(false),
+      shot_started(0) {
+  sampling.setPreference(SCD4X_DEFAULT_SAMPLING);
+  memset(&dev, 0, sizeof(i2c_dev_t));
+  memset(serial, 0, sizeof(serial));
+  command_queue = xQueueCreate(SCD4X_COMMAND_QUEUE_LEN, sizeof(Command));
+}
 
 esp_err_t Scd4xManager::init(int sda_pin, int scl_pin) {
   // Initialize standard I2C descriptor for SCD4x
@@ -24,7 +53,8 @@ esp_err_t Scd4xManager::init(int sda_pin, int scl_pin) {
   // warm reboots) We ignore the error because it might fail if the sensor is
   // already idle, or if comms are glitchy at start
   scd4x_stop_periodic_measurement(&dev);
-  vTaskDelay(pdMS_TO_TICKS(500));
+  vTaskDelay(pdMS_TO_TICKS(SCD4X_STOP_DELAY_MS));
+  mode = SCD4X_MODE_IDLE;
 
   // Disable wake_up for now as it's typically for low-power mode exit, and
   // stop_periodic handles the main active state scd4x_wake_up(&dev);
@@ -34,156 +64,360 @@ esp_err_t Scd4xManager::init(int sda_pin, int scl_pin) {
   vTaskDelay(pdMS_TO_TICKS(30));
   ESP_LOGI(TAG, "Sensor initialized");
 
-  uint16_t serial[3];
   ESP_ERROR_CHECK(
       scd4x_get_serial_number(&dev, serial, serial + 1, serial + 2));
+  serial_valid = true;
   ESP_LOGI(TAG, "Sensor serial number: 0x%04x%04x%04x", serial[0], serial[1],
            serial[2]);
 
+  // Fill the cache while the sensor is idle anyway
+  readSettings();
+
   return ESP_OK;
 }
 
-void Scd4xManager::start() {
-  // Start periodic measurements
-  ESP_ERROR_CHECK(scd4x_start_periodic_measurement(&dev));
-  ESP_LOGI(TAG, "Periodic measurements started");
+void Scd4xManager::readSettings() {
+  if (scd4x_get_sensor_variant(&dev, &variant) == ESP_OK) {
+    variant_valid = true;
+  }
+  asc_valid =
+      (scd4x_get_automatic_self_calibration(&dev, &asc_enabled) == ESP_OK);
 
-  xTaskCreate(task, "scd4x_task", 4096, this, 5, NULL);
+  // Variant bits 15:12 are 0 for the SCD40, which has no single shot mode
+  sampling.setSingleShotSupported(variant_valid && (variant & 0xF000) != 0);
+  ESP_LOGI(TAG, "Settings cached: variant 0x%04x, ASC %s", variant,
+           asc_valid ? (asc_enabled ? "on" : "off") : "unknown");
 }
 
-esp_err_t Scd4xManager::toggleASC() {
-  bool enabled;
-  ESP_LOGI(TAG, "Toggling ASC...");
+esp_err_t Scd4xManager::enterMode(Scd4xMode target) {
+  if (target == mode)
+    return ESP_OK;
 
-  // Must stop measurements to change settings
-  scd4x_stop_periodic_measurement(&dev);
-  vTaskDelay(pdMS_TO_TICKS(500));
+  // Leave the current mode, only periodic modes need an explicit stop
+  if (mode == SCD4X_MODE_PERIODIC || mode == SCD4X_MODE_LOW_POWER_PERIODIC) {
+    scd4x_stop_periodic_measurement(&dev);
+    vTaskDelay(pdMS_TO_TICKS(SCD4X_STOP_DELAY_MS));
+  }
+  mode = SCD4X_MODE_IDLE;
+
+  esp_err_t err = ESP_OK;
+  switch (target) {
+  case SCD4X_MODE_PERIODIC:
+    err = scd4x_start_periodic_measurement(&dev);
+    break;
+  case SCD4X_MODE_LOW_POWER_PERIODIC:
+    err = scd4x_start_low_power_periodic_measurement(&dev);
+    break;
+  default:
+    // Idle and single shot need no command
+    break;
+  }
 
-  esp_err_t err = scd4x_get_automatic_self_calibration(&dev, &enabled);
   if (err == ESP_OK) {
-    bool new_state = !enabled;
-    err = scd4x_set_automatic_self_calibration(&dev, new_state);
-    if (err == ESP_OK) {
-      scd4x_persist_settings(&dev);
-      ESP_LOGI(TAG, "ASC now %s", new_state ? "Enabled" : "Disabled");
+    mode = target;
+    ESP_LOGD(TAG, "Sensor mode %d", mode);
+    // A restarted measurement has a new phase
+    if (mode == SCD4X_MODE_LOW_POWER_PERIODIC) {
+      phase.reset(SCD4X_LOW_POWER_PERIODIC_MS * 1000LL);
+    } else if (mode == SCD4X_MODE_PERIODIC) {
+      phase.reset(SCD4X_PERIODIC_MS * 1000LL);
     }
+  } else {
+    ESP_LOGE(TAG, "Failed to enter mode %d: %s", target, esp_err_to_name(err));
   }
-
-  scd4x_start_periodic_measurement(&dev);
   return err;
 }
 
-esp_err_t Scd4xManager::getASCStatus(bool *enabled) {
-  // Must stop measurements to check settings
-  scd4x_stop_periodic_measurement(&dev);
-  vTaskDelay(pdMS_TO_TICKS(500));
+void Scd4xManager::start() {
+  // Start periodic measurements, the sampling policy takes over once
+  // samples arrive
+  ESP_ERROR_CHECK(enterMode(measure_mode));
+  ESP_LOGI(TAG, "Periodic measurements started");
 
-  esp_err_t err = scd4x_get_automatic_self_calibration(&dev, enabled);
+  xTaskCreate(task, "scd4x_task", 4096, this, 5, NULL);
+}
 
-  scd4x_start_periodic_measurement(&dev);
-  return err;
+esp_err_t Scd4xManager::submit(Scd4xCommandType type, uint16_t arg,
+                               Scd4xCompletion done, void *ctx) {
+  Command command = {type, arg, done, ctx};
+  if (!command_queue || xQueueSend(command_queue, &command, 0) != pdTRUE) {
+    ESP_LOGW(TAG, "Command queue full, dropping command %d", type);
+    return ESP_ERR_NO_MEM;
+  }
+  return ESP_OK;
 }
 
-esp_err_t Scd4xManager::performFRC(uint16_t target_ppm) {
-  uint16_t correction;
-  ESP_LOGI(TAG, "Performing FRC at %u ppm...", target_ppm);
+esp_err_t Scd4xManager::toggleASC(Scd4xCompletion done, void *ctx) {
+  return submit(SCD4X_CMD_TOGGLE_ASC, 0, done, ctx);
+}
 
-  // Must stop measurements
-  scd4x_stop_periodic_measurement(&dev);
-  vTaskDelay(pdMS_TO_TICKS(500));
+esp_err_t Scd4xManager::getASCStatus(Scd4xCompletion done, void *ctx) {
+  return submit(SCD4X_CMD_GET_ASC, 0, done, ctx);
+}
 
-  esp_err_t err =
-      scd4x_perform_forced_recalibration(&dev, target_ppm, &correction);
-  if (err == ESP_OK) {
-    if (correction == 0xFFFF) {
-      ESP_LOGE(TAG, "FRC failed!");
-      err = ESP_FAIL;
-    } else {
-      ESP_LOGI(TAG, "FRC successful, correction: %u ppm", correction);
-    }
-  }
+esp_err_t Scd4xManager::performFRC(uint16_t target_ppm, Scd4xCompletion done,
+                                   void *ctx) {
+  return submit(SCD4X_CMD_FRC, target_ppm, done, ctx);
+}
 
-  scd4x_start_periodic_measurement(&dev);
-  return err;
+esp_err_t Scd4xManager::getSerialNumber(Scd4xCompletion done, void *ctx) {
+  return submit(SCD4X_CMD_GET_SERIAL, 0, done, ctx);
 }
 
-esp_err_t Scd4xManager::getSerialNumber(uint16_t &w0, uint16_t &w1,
-                                        uint16_t &w2) {
-  // Can be read during periodic measurement? Datasheet says "reading out... can
-  // be used...". Usually needs idle? The datasheet doesn't explicitly say "only
-  // in idle" for serial number in the summary table, but typically safest in
-  // idle. scd4x.h doc says scd4x_get_serial_number.
+esp_err_t Scd4xManager::performSelfTest(Scd4xCompletion done, void *ctx) {
+  return submit(SCD4X_CMD_SELF_TEST, 0, done, ctx);
+}
 
-  // To be safe and compliant with typical Sensirion flows, we'll stop periodic.
-  scd4x_stop_periodic_measurement(&dev);
-  vTaskDelay(pdMS_TO_TICKS(500));
+esp_err_t Scd4xManager::performFactoryReset(Scd4xCompletion done, void *ctx) {
+  return submit(SCD4X_CMD_FACTORY_RESET, 0, done, ctx);
+}
 
-  esp_err_t err = scd4x_get_serial_number(&dev, &w0, &w1, &w2);
+esp_err_t Scd4xManager::reinit(Scd4xCompletion done, void *ctx) {
+  return submit(SCD4X_CMD_REINIT, 0, done, ctx);
+}
 
-  scd4x_start_periodic_measurement(&dev);
-  return err;
+esp_err_t Scd4xManager::getSensorVariant(Scd4xCompletion done, void *ctx) {
+  return submit(SCD4X_CMD_GET_VARIANT, 0, done, ctx);
 }
 
-esp_err_t Scd4xManager::performSelfTest(bool &malfunction) {
-  ESP_LOGI(TAG, "Performing self test...");
-  scd4x_stop_periodic_measurement(&dev);
-  vTaskDelay(pdMS_TO_TICKS(500));
+esp_err_t Scd4xManager::setSamplingPreference(SamplingPreference preference,
+                                              Scd4xCompletion done,
+                                              void *ctx) {
+  return submit(SCD4X_CMD_SET_SAMPLING, preference, done, ctx);
+}
 
-  esp_err_t err = scd4x_perform_self_test(&dev, &malfunction);
-  if (err == ESP_OK) {
-    // Datasheet specifies a self-test execution time of ~10 000 ms; wait before
-    // restarting periodic measurement to ensure the sensor has fully completed
-    // the test, even if the driver already blocks internally.
-    vTaskDelay(pdMS_TO_TICKS(10000));
-    ESP_LOGI(TAG, "Self test result: %s", malfunction ? "Malfunction" : "OK");
-  } else {
-    ESP_LOGE(TAG, "Self test command failed");
+static Scd4xMode mode_for_rate(SamplingRate rate) {
+  switch (rate) {
+  case SAMPLE_SINGLE_SHOT:
+    return SCD4X_MODE_SINGLE_SHOT;
+  case SAMPLE_LOW_POWER:
+    return SCD4X_MODE_LOW_POWER_PERIODIC;
+  default:
+    return SCD4X_MODE_PERIODIC;
   }
+}
 
-  scd4x_start_periodic_measurement(&dev);
-  return err;
+void Scd4xManager::updateSamplingMode() {
+  int64_t now_us = esp_timer_get_time();
+  DeviceStatus status = global_data.getStatus();
+  time_t now;
+  struct tm timeinfo;
+  time(&now);
+  localtime_r(&now, &timeinfo);
+
+  SamplingDecision decision =
+      sampling.decide(status.battery_voltage, timeinfo.tm_hour, now_us);
+  single_shot_interval_ms = decision.interval_ms;
+
+  Scd4xMode target = mode_for_rate(decision.rate);
+  if (target != measure_mode) {
+    ESP_LOGI(TAG, "Sampling mode %d -> %d (CO2 trend %.1f ppm/min)",
+             measure_mode, target, sampling.getSlope());
+    measure_mode = target;
+    enterMode(target);
+  }
 }
 
-esp_err_t Scd4xManager::performFactoryReset() {
-  ESP_LOGI(TAG, "Performing factory reset...");
-  scd4x_stop_periodic_measurement(&dev);
-  vTaskDelay(pdMS_TO_TICKS(500));
+void Scd4xManager::applySamplingPolicy(uint16_t co2) {
+  sampling.addSample(co2, esp_timer_get_time());
+  updateSamplingMode();
+}
 
-  esp_err_t err = scd4x_perform_factory_reset(&dev);
-  if (err == ESP_OK) {
-    // Wait 1200 ms
-    vTaskDelay(pdMS_TO_TICKS(1200));
-    ESP_LOGI(TAG, "Factory reset complete");
+TickType_t Scd4xManager::sampleDelay() const {
+  switch (mode) {
+  case SCD4X_MODE_LOW_POWER_PERIODIC:
+    return pdMS_TO_TICKS(SCD4X_LOW_POWER_PERIODIC_MS - SCD4X_POLL_LEAD_MS);
+  case SCD4X_MODE_SINGLE_SHOT:
+    return pdMS_TO_TICKS(single_shot_interval_ms);
+  default:
+    return pdMS_TO_TICKS(SCD4X_PERIODIC_MS - SCD4X_POLL_LEAD_MS);
   }
-
-  scd4x_start_periodic_measurement(&dev);
-  return err;
 }
 
-esp_err_t Scd4xManager::reinit() {
-  ESP_LOGI(TAG, "Reinitializing sensor...");
-  scd4x_stop_periodic_measurement(&dev);
-  vTaskDelay(pdMS_TO_TICKS(500));
+void Scd4xManager::execute(const Command &command, Scd4xResult &result) {
+  esp_err_t err = ESP_OK;
 
-  esp_err_t err = scd4x_reinit(&dev);
-  if (err == ESP_OK) {
-    // Datasheet: reinit command execution time t_reinit = 20 ms; use 30 ms
-    // here to provide a safety margin.
-    vTaskDelay(pdMS_TO_TICKS(30));
+  switch (command.type) {
+  case SCD4X_CMD_GET_ASC:
+    err = scd4x_get_automatic_self_calibration(&dev, &result.asc_enabled);
+    if (err == ESP_OK) {
+      asc_enabled = result.asc_enabled;
+      asc_valid = true;
+    }
+    break;
+
+  case SCD4X_CMD_TOGGLE_ASC: {
+    ESP_LOGI(TAG, "Toggling ASC...");
+    bool enabled = asc_enabled;
+    if (!asc_valid) {
+      err = scd4x_get_automatic_self_calibration(&dev, &enabled);
+    }
+    if (err == ESP_OK) {
+      bool new_state = !enabled;
+      err = scd4x_set_automatic_self_calibration(&dev, new_state);
+      if (err == ESP_OK) {
+        scd4x_persist_settings(&dev);
+        asc_enabled = new_state;
+        asc_valid = true;
+        result.asc_enabled = new_state;
+        ESP_LOGI(TAG, "ASC now %s", new_state ? "Enabled" : "Disabled");
+      }
+    }
+    break;
   }
 
-  scd4x_start_periodic_measurement(&dev);
-  return err;
+  case SCD4X_CMD_FRC:
+    ESP_LOGI(TAG, "Performing FRC at %u ppm...", command.arg);
+    err = scd4x_perform_forced_recalibration(&dev, command.arg,
+                                             &result.correction);
+    if (err == ESP_OK) {
+      if (result.correction == 0xFFFF) {
+        ESP_LOGE(TAG, "FRC failed!");
+        err = ESP_FAIL;
+      } else {
+        ESP_LOGI(TAG, "FRC successful, correction: %u ppm",
+                 result.correction);
+      }
+    }
+    break;
+
+  case SCD4X_CMD_SELF_TEST:
+    ESP_LOGI(TAG, "Performing self test...");
+    err = scd4x_perform_self_test(&dev, &result.malfunction);
+    if (err == ESP_OK) {
+      // Datasheet specifies a self-test execution time of ~10 000 ms; wait
+      // before restarting periodic measurement to ensure the sensor has fully
+      // completed the test, even if the driver already blocks internally.
+      vTaskDelay(pdMS_TO_TICKS(10000));
+      ESP_LOGI(TAG, "Self test result: %s",
+               result.malfunction ? "Malfunction" : "OK");
+    } else {
+      ESP_LOGE(TAG, "Self test command failed");
+    }
+    break;
+
+  case SCD4X_CMD_FACTORY_RESET:
+    ESP_LOGI(TAG, "Performing factory reset...");
+    err = scd4x_perform_factory_reset(&dev);
+    if (err == ESP_OK) {
+      // Wait 1200 ms
+      vTaskDelay(pdMS_TO_TICKS(1200));
+      ESP_LOGI(TAG, "Factory reset complete");
+    }
+    // Settings are back to defaults
+    readSettings();
+    break;
+
+  case SCD4X_CMD_REINIT:
+    ESP_LOGI(TAG, "Reinitializing sensor...");
+    err = scd4x_reinit(&dev);
+    if (err == ESP_OK) {
+      // Datasheet: reinit command execution time t_reinit = 20 ms; use 30 ms
+      // here to provide a safety margin.
+      vTaskDelay(pdMS_TO_TICKS(30));
+    }
+    // Settings are reloaded from EEPROM
+    readSettings();
+    break;
+
+  case SCD4X_CMD_GET_SERIAL:
+    err = scd4x_get_serial_number(&dev, &serial[0], &serial[1], &serial[2]);
+    if (err == ESP_OK) {
+      serial_valid = true;
+      memcpy(result.serial, serial, sizeof(serial));
+    }
+    break;
+
+  case SCD4X_CMD_GET_VARIANT:
+    err = scd4x_get_sensor_variant(&dev, &variant);
+    if (err == ESP_OK) {
+      variant_valid = true;
+      result.variant = variant;
+    }
+    break;
+
+  case SCD4X_CMD_SET_SAMPLING:
+    // Handled by runLocally
+    break;
+  }
+
+  result.err = err;
 }
 
-esp_err_t Scd4xManager::getSensorVariant(uint16_t &variant) {
-  scd4x_stop_periodic_measurement(&dev);
-  vTaskDelay(pdMS_TO_TICKS(500));
+bool Scd4xManager::runLocally(const Command &command, Scd4xResult &result) {
+  switch (command.type) {
+  case SCD4X_CMD_SET_SAMPLING:
+    ESP_LOGI(TAG, "Sampling preference %u", command.arg);
+    sampling.setPreference((SamplingPreference)command.arg);
+    result.sampling = command.arg;
+    updateSamplingMode();
+    return true;
+  case SCD4X_CMD_GET_ASC:
+    result.asc_enabled = asc_enabled;
+    return asc_valid;
+  case SCD4X_CMD_GET_SERIAL:
+    memcpy(result.serial, serial, sizeof(serial));
+    return serial_valid;
+  case SCD4X_CMD_GET_VARIANT:
+    result.variant = variant;
+    return variant_valid;
+  default:
+    return false;
+  }
+}
 
-  esp_err_t err = scd4x_get_sensor_variant(&dev, &variant);
+bool Scd4xManager::runCommands(const Command &first) {
+  Command batch[SCD4X_COMMAND_QUEUE_LEN + 1];
+  int count = 0;
+  batch[count++] = first;
+  while (count < SCD4X_COMMAND_QUEUE_LEN + 1 &&
+         xQueueReceive(command_queue, &batch[count], 0) == pdTRUE) {
+    count++;
+  }
 
-  scd4x_start_periodic_measurement(&dev);
-  return err;
+  // Cached reads complete right away, the rest share one idle window. A
+  // read queued behind a command that talks to the sensor waits for it, so
+  // it sees the state that command leaves behind.
+  Scd4xResult results[SCD4X_COMMAND_QUEUE_LEN + 1];
+  bool needs_idle[SCD4X_COMMAND_QUEUE_LEN + 1];
+  int idle_count = 0;
+  for (int i = 0; i < count; i++) {
+    results[i] = {};
+    results[i].type = batch[i].type;
+    needs_idle[i] = idle_count > 0 || !runLocally(batch[i], results[i]);
+    if (needs_idle[i]) {
+      idle_count++;
+    } else if (batch[i].done) {
+      batch[i].done(results[i], batch[i].ctx);
+    }
+  }
+  if (idle_count == 0)
+    return false;
+
+  ESP_LOGI(TAG, "Running %d command(s) in one idle window", idle_count);
+  bool interrupted = (mode == SCD4X_MODE_PERIODIC ||
+                      mode == SCD4X_MODE_LOW_POWER_PERIODIC);
+  enterMode(SCD4X_MODE_IDLE);
+  for (int i = 0; i < count; i++) {
+    if (needs_idle[i] && !runLocally(batch[i], results[i])) {
+      execute(batch[i], results[i]);
+    }
+  }
+  enterMode(measure_mode);
+
+  for (int i = 0; i < count; i++) {
+    if (needs_idle[i] && batch[i].done) {
+      batch[i].done(results[i], batch[i].ctx);
+    }
+  }
+  return interrupted;
+}
+
+// Ticks from now until an esp_timer timestamp, at least one
+static TickType_t ticks_until(int64_t time_us) {
+  int64_t delta_ms = (time_us - esp_timer_get_time() + 999) / 1000;
+  TickType_t ticks = (delta_ms > 0) ? pdMS_TO_TICKS(delta_ms) : 0;
+  return (ticks > 0) ? ticks : 1;
 }
 
 void Scd4xManager::task(void *pvParameters) {
@@ -192,20 +426,75 @@ void Scd4xManager::task(void *pvParameters) {
   uint16_t co2;
   float temperature, humidity;
 
+  TickType_t next_poll = xTaskGetTickCount();
+  bool scheduled_check = false; // Next check is a phase scheduled one
+  uint32_t checks = 0;          // Status checks for the current sample
+
   while (1) {
+    TickType_t now = xTaskGetTickCount();
+    int32_t wait = (int32_t)(next_poll - now); // Wrap safe
+    if (wait < 0) {
+      wait = 0;
+    }
+
+    // Sleep until the next poll, serving commands that arrive meanwhile.
+    // A running single shot must not be interrupted, commands wait for it.
+    Command command;
+    if (self->shot_pending) {
+      vTaskDelay((TickType_t)wait);
+    } else if (xQueueReceive(self->command_queue, &command,
+                             (TickType_t)wait) == pdTRUE) {
+      Scd4xMode before = self->mode;
+      if (self->runCommands(command) || self->mode != before) {
+        // Measurement restarted, the next sample is a full period away
+        next_poll = xTaskGetTickCount() + self->sampleDelay();
+        scheduled_check = false;
+      }
+      continue;
+    }
+
+    // Single shot mode: trigger a measurement when one is due
+    if (self->mode == SCD4X_MODE_SINGLE_SHOT && !self->shot_pending) {
+      self->shot_started = xTaskGetTickCount();
+      if (scd4x_measure_single_shot(&self->dev) == ESP_OK) {
+        self->shot_pending = true;
+        next_poll = self->shot_started + pdMS_TO_TICKS(SCD4X_SINGLE_SHOT_MS);
+      } else {
+        ESP_LOGW(TAG, "Single shot trigger failed");
+        next_poll = xTaskGetTickCount() + pdMS_TO_TICKS(1000);
+      }
+      continue;
+    }
+
+    // Anything but a successful read below falls back to polling
+    next_poll = xTaskGetTickCount() + pdMS_TO_TICKS(SCD4X_POLL_MS);
+    bool was_scheduled = scheduled_check;
+    scheduled_check = false;
+
+    // Give up on a single shot that never completes
+    if (self->shot_pending &&
+        xTaskGetTickCount() - self->shot_started >
+            pdMS_TO_TICKS(2 * SCD4X_SINGLE_SHOT_MS)) {
+      ESP_LOGW(TAG, "Single shot timed out");
+      self->shot_pending = false;
+      continue;
+    }
+
     bool data_ready = false;
-    // Poll data ready flag every 100ms
+    int64_t check_us = esp_timer_get_time();
     esp_err_t res = scd4x_get_data_ready_status(&self->dev, &data_ready);
+    checks++;
 
     if (res != ESP_OK) {
       // If checking status fails, just wait a bit and retry
-      vTaskDelay(pdMS_TO_TICKS(100));
       continue;
     }
 
     if (!data_ready) {
-      // Data not ready yet, wait 100ms
-      vTaskDelay(pdMS_TO_TICKS(100));
+      // Expected sample is late, poll until it shows up and re-anchor
+      if (was_scheduled) {
+        self->phase.onNotReady();
+      }
       continue;
     }
 
@@ -214,24 +503,44 @@ void Scd4xManager::task(void *pvParameters) {
 
     // Data is ready, read it
     res = scd4x_read_measurement(&self->dev, &co2, &temperature, &humidity);
+    self->shot_pending = false;
     if (res != ESP_OK) {
       ESP_LOGE(TAG, "Error reading results %d (%s)", res, esp_err_to_name(res));
       continue;
     }
 
+    ESP_LOGD(TAG, "Sample after %lu status check(s)", checks);
+    checks = 0;
+
+    // An invalid sample still completed a measurement period, so the next
+    // read is scheduled from it like from a valid one
+    Scd4xMode before = self->mode;
     if (co2 == 0) {
       ESP_LOGW(TAG, "Invalid sample detected, skipping");
-      continue;
-    }
+    } else {
+      ESP_LOGI(TAG, "CO2: %u ppm, Temp: %.2f C, Hum: %.2f %%", co2,
+               temperature, humidity);
 
-    ESP_LOGI(TAG, "CO2: %u ppm, Temp: %.2f C, Hum: %.2f %%", co2, temperature,
-             humidity);
+      global_data.setEnvironmental(co2, temperature, humidity);
+      data_bus.publish(TOPIC_CO2, co2);
+      data_bus.publish(TOPIC_TEMPERATURE, temperature);
+      data_bus.publish(TOPIC_HUMIDITY, humidity);
 
-    DeviceStatus status = global_data.getStatus();
-    global_data.setEnvironmental(co2, temperature, humidity, status.altitude);
+      // Let the policy pick the cadence. A mode switch resets the phase.
+      self->applySamplingPolicy(co2);
+    }
 
-    // Wait a bit to avoid excessive polling right after reading
-    // Next sample will be ready in ~5 seconds
-    vTaskDelay(pdMS_TO_TICKS(4000));
+    if (self->mode != before || self->mode == SCD4X_MODE_SINGLE_SHOT) {
+      next_poll = xTaskGetTickCount() + self->sampleDelay();
+    } else {
+      // Periodic: schedule one check just after the next completion
+      self->phase.onReady(check_us, was_scheduled);
+      if (self->phase.locked()) {
+        next_poll = xTaskGetTickCount() + ticks_until(self->phase.nextCheckTime());
+        scheduled_check = true;
+      } else {
+        next_poll = xTaskGetTickCount() + self->sampleDelay();
+      }
+    }
   }
 }
@@ -2,28 +2,149 @@
 
 #include <esp_err.h>
 #include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
 #include <freertos/task.h>
 #include <i2cdev.h>
 #include <scd4x.h>
 
+#include "sample_phase.hpp"
+#include "sampling_policy.hpp"
+
+// Depth of the sensor command queue
+#define SCD4X_COMMAND_QUEUE_LEN 4
+
+// Sampling mode at boot, see SamplingPreference
+#define SCD4X_DEFAULT_SAMPLING SAMPLING_AUTO
+
+enum Scd4xCommandType {
+  SCD4X_CMD_GET_ASC,
+  SCD4X_CMD_TOGGLE_ASC,
+  SCD4X_CMD_FRC,
+  SCD4X_CMD_SELF_TEST,
+  SCD4X_CMD_FACTORY_RESET,
+  SCD4X_CMD_REINIT,
+  SCD4X_CMD_GET_SERIAL,
+  SCD4X_CMD_GET_VARIANT,
+  SCD4X_CMD_SET_SAMPLING,
+};
+
+enum Scd4xMode {
+  SCD4X_MODE_IDLE,
+  SCD4X_MODE_PERIODIC,           // 5 s cadence
+  SCD4X_MODE_LOW_POWER_PERIODIC, // 30 s cadence
+  SCD4X_MODE_SINGLE_SHOT,        // Idle between on-demand measurements
+};
+
+/**
+ * @brief Outcome of a sensor command, fields are set per command type
+ */
+struct Scd4xResult {
+  Scd4xCommandType type;
+  esp_err_t err;
+  bool asc_enabled;    // GET_ASC, TOGGLE_ASC (new state)
+  uint16_t correction; // FRC
+  bool malfunction;    // SELF_TEST
+  uint16_t serial[3];  // GET_SERIAL
+  uint16_t variant;    // GET_VARIANT
+  uint8_t sampling;    // SET_SAMPLING (SamplingPreference)
+};
+
+// Called from the sensor task when a command finishes
+typedef void (*Scd4xCompletion)(const Scd4xResult &result, void *ctx);
+
+/**
+ * @brief Owns the SCD4x and runs measurements and commands on one task
+ *
+ * Commands are queued and executed by the sensor task between samples, so
+ * callers never block on the sensor and never share the I2C device with the
+ * measurement loop. Results are delivered through the completion callback.
+ *
+ * Serial number, variant and the ASC flag are cached, reads of them are
+ * answered without interrupting measurement. Commands that need the sensor
+ * idle are batched into a single stop/start window.
+ */
 class Scd4xManager {
 public:
   Scd4xManager();
   esp_err_t init(int sda_pin, int scl_pin);
   void start();
 
-  esp_err_t toggleASC();
-  esp_err_t getASCStatus(bool *enabled);
-  esp_err_t performFRC(uint16_t target_ppm);
+  esp_err_t toggleASC(Scd4xCompletion done = nullptr, void *ctx = nullptr);
+  esp_err_t getASCStatus(Scd4xCompletion done, void *ctx = nullptr);
+  esp_err_t performFRC(uint16_t target_ppm, Scd4xCompletion done = nullptr,
+                       void *ctx = nullptr);
+
+  esp_err_t getSerialNumber(Scd4xCompletion done, void *ctx = nullptr);
+  esp_err_t performSelfTest(Scd4xCompletion done, void *ctx = nullptr);
+  esp_err_t performFactoryReset(Scd4xCompletion done = nullptr,
+                                void *ctx = nullptr);
+  esp_err_t reinit(Scd4xCompletion done = nullptr, void *ctx = nullptr);
+  esp_err_t getSensorVariant(Scd4xCompletion done, void *ctx = nullptr);
 
-  esp_err_t getSerialNumber(uint16_t &w0, uint16_t &w1, uint16_t &w2);
-  esp_err_t performSelfTest(bool &malfunction);
-  esp_err_t performFactoryReset();
-  esp_err_t reinit();
-  esp_err_t getSensorVariant(uint16_t &variant);
+  /**
+   * @brief Select fixed fast, low power or single shot sampling, or let the
+   * adaptive policy decide
+   */
+  esp_err_t setSamplingPreference(SamplingPreference preference,
+                                  Scd4xCompletion done = nullptr,
+                                  void *ctx = nullptr);
+
+  Scd4xMode getMode() const { return mode; }
 
 private:
+  struct Command {
+    Scd4xCommandType type;
+    uint16_t arg;
+    Scd4xCompletion done;
+    void *ctx;
+  };
+
   static void task(void *pvParameters);
 
+  // Queue a command, ESP_ERR_NO_MEM if the queue is full
+  esp_err_t submit(Scd4xCommandType type, uint16_t arg, Scd4xCompletion done,
+                   void *ctx);
+
+  // Run a command on the sensor task, measurement must be stopped
+  void execute(const Command &command, Scd4xResult &result);
+  // Answer a read from the settings cache or handle a command that does not
+  // talk to the sensor, false if the sensor is needed
+  bool runLocally(const Command &command, Scd4xResult &result);
+  // Run a command plus everything queued behind it in one idle window.
+  // Returns true if measurement was interrupted.
+  bool runCommands(const Command &first);
+
+  // Switch measurement mode, stopping periodic measurement if needed
+  esp_err_t enterMode(Scd4xMode target);
+  // Read cached settings, sensor must be idle
+  void readSettings();
+
+  // Feed a sample to the sampling policy and switch modes if it says so
+  void applySamplingPolicy(uint16_t co2);
+  void updateSamplingMode();
+  // Time from a sample (or mode start) until the next one is due
+  TickType_t sampleDelay() const;
+
   i2c_dev_t dev;
+  QueueHandle_t command_queue;
+
+  Scd4xMode mode;         // Current sensor state
+  Scd4xMode measure_mode; // Mode to return to after commands
+
+  // Settings cache
+  uint16_t serial[3];
+  bool serial_valid;
+  uint16_t variant;
+  bool variant_valid;
+  bool asc_enabled;
+  bool asc_valid;
+
+  // Adaptive sampling
+  SamplingPolicy sampling;
+  uint32_t single_shot_interval_ms;
+  bool shot_pending; // Single shot measurement running
+  TickType_t shot_started;
+
+  // Completion phase of periodic samples
+  SamplePhaseTracker phase;
 };
@@ -0,0 +1,380 @@
+#include "scd4x_sim.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <string.h>
+
+static const char *TAG = "Scd4xSim";
+
+// Command execution times per the datasheet, in ms
+#define SIM_EXEC_DEFAULT_MS 1
+#define SIM_EXEC_STOP_MS 500
+#define SIM_EXEC_PERSIST_MS 800
+#define SIM_EXEC_FRC_MS 400
+#define SIM_EXEC_SELF_TEST_MS 10000
+#define SIM_EXEC_FACTORY_RESET_MS 1200
+#define SIM_EXEC_REINIT_MS 30
+
+// Measurement periods per the datasheet, in us
+#define SIM_PERIODIC_US 5000000LL
+#define SIM_LOW_POWER_US 30000000LL
+#define SIM_SINGLE_SHOT_US 5000000LL
+
+// Log the hourly counters this often
+#define SIM_REPORT_US (3600LL * 1000000LL)
+
+enum SimState {
+  SIM_IDLE,
+  SIM_PERIODIC,
+  SIM_LOW_POWER,
+  SIM_SHOT,
+};
+
+struct Sim {
+  SimState state;
+  int64_t started_us;   // Start of the running measurement
+  int64_t period_us;    // Sample period with the clock error applied
+  uint32_t completed;   // Samples completed since started_us
+  bool ready;           // Unread sample available
+  int64_t stopped_us;   // Commands are rejected until this time
+  int64_t accounted_us; // Active time is accounted up to here
+  int64_t reported_us;
+  bool asc;
+  bool asc_persisted;
+  int16_t offset; // CO2 offset applied by FRC
+  uint32_t rng;
+  Scd4xSimStats stats;
+  int64_t stats_start_us;
+};
+
+static Sim sim;
+static portMUX_TYPE sim_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Sensor clock error applied to a nominal period
+static int64_t skewed(int64_t period_us) {
+  return period_us + period_us * SCD4X_SIM_CLOCK_PPM / 1000000;
+}
+
+// Account one transfer of the given number of bytes, address included
+static void bus_transfer(size_t bytes) {
+  portENTER_CRITICAL(&sim_lock);
+  sim.stats.transactions++;
+  sim.stats.bus_busy_us += (int64_t)bytes * 9 * 1000000 / SCD4X_SIM_BUS_HZ;
+  portEXIT_CRITICAL(&sim_lock);
+}
+
+// Advance the measurement state machine to now
+static void update(int64_t now) {
+  portENTER_CRITICAL(&sim_lock);
+  if (sim.state == SIM_PERIODIC || sim.state == SIM_LOW_POWER) {
+    sim.stats.active_us += now - sim.accounted_us;
+    uint32_t completed = (uint32_t)((now - sim.started_us) / sim.period_us);
+    if (completed != sim.completed) {
+      sim.stats.samples += completed - sim.completed;
+      sim.completed = completed;
+      sim.ready = true;
+    }
+  } else if (sim.state == SIM_SHOT && now >= sim.started_us + sim.period_us) {
+    sim.stats.active_us += sim.started_us + sim.period_us - sim.accounted_us;
+    sim.stats.samples++;
+    sim.ready = true;
+    sim.state = SIM_IDLE;
+  } else if (sim.state == SIM_SHOT) {
+    sim.stats.active_us += now - sim.accounted_us;
+  }
+  sim.accounted_us = now;
+  sim.stats.elapsed_us = now - sim.stats_start_us;
+  bool report = now - sim.reported_us >= SIM_REPORT_US;
+  if (report) {
+    sim.reported_us = now;
+  }
+  portEXIT_CRITICAL(&sim_lock);
+
+  if (report) {
+    Scd4xSimStats hourly;
+    scd4x_sim_get_hourly_stats(&hourly);
+    ESP_LOGI(TAG,
+             "Per hour: %lu transfers, bus busy %lld us, active %lld s, "
+             "%lu samples, %lu read, %lu ready polls",
+             hourly.transactions, hourly.bus_busy_us,
+             hourly.active_us / 1000000, hourly.samples, hourly.samples_read,
+             hourly.ready_polls);
+  }
+}
+
+/**
+ * @brief Send a command and wait for its execution time
+ * @param args Input words, each sent with a CRC byte
+ * @param during_meas Command is accepted while measurement is running
+ * @return ESP_OK, or ESP_FAIL if the sensor would not acknowledge it
+ */
+static esp_err_t command(int args, uint32_t exec_ms, bool during_meas) {
+  int64_t now = esp_timer_get_time();
+  update(now);
+  bus_transfer(3 + 3 * args);
+
+  bool measuring = sim.state != SIM_IDLE;
+  if (now < sim.stopped_us || (measuring && !during_meas)) {
+    // The sensor does not acknowledge the address while busy
+    portENTER_CRITICAL(&sim_lock);
+    sim.stats.nacks++;
+    portEXIT_CRITICAL(&sim_lock);
+    return ESP_FAIL;
+  }
+
+  // Sub-tick execution times still yield for one tick
+  TickType_t ticks = pdMS_TO_TICKS(exec_ms);
+  if (exec_ms > 0) {
+    vTaskDelay(ticks > 0 ? ticks : 1);
+  }
+  return ESP_OK;
+}
+
+// Read back the response words of the last command
+static void response(int words) { bus_transfer(1 + 3 * words); }
+
+// Deterministic pseudo random value in [0, range)
+static uint32_t next_random(uint32_t range) {
+  sim.rng = sim.rng * 1664525u + 1013904223u;
+  return (sim.rng >> 8) % range;
+}
+
+static void start_measurement(SimState state, int64_t period_us) {
+  int64_t now = esp_timer_get_time();
+  portENTER_CRITICAL(&sim_lock);
+  sim.state = state;
+  sim.started_us = now;
+  sim.accounted_us = now;
+  sim.period_us = skewed(period_us);
+  sim.completed = 0;
+  sim.ready = false;
+  portEXIT_CRITICAL(&sim_lock);
+}
+
+void scd4x_sim_get_stats(Scd4xSimStats *stats) {
+  portENTER_CRITICAL(&sim_lock);
+  *stats = sim.stats;
+  portEXIT_CRITICAL(&sim_lock);
+}
+
+// Scale a counter accumulated over elapsed_us to one hour
+static int64_t per_hour(int64_t value, int64_t elapsed_us) {
+  return value * (3600LL * 1000000LL) / elapsed_us;
+}
+
+void scd4x_sim_get_hourly_stats(Scd4xSimStats *stats) {
+  scd4x_sim_get_stats(stats);
+  int64_t elapsed = stats->elapsed_us;
+  if (elapsed <= 0) {
+    return;
+  }
+  stats->transactions = (uint32_t)per_hour(stats->transactions, elapsed);
+  stats->nacks = (uint32_t)per_hour(stats->nacks, elapsed);
+  stats->bus_busy_us = per_hour(stats->bus_busy_us, elapsed);
+  stats->active_us = per_hour(stats->active_us, elapsed);
+  stats->samples = (uint32_t)per_hour(stats->samples, elapsed);
+  stats->samples_read = (uint32_t)per_hour(stats->samples_read, elapsed);
+  stats->ready_polls = (uint32_t)per_hour(stats->ready_polls, elapsed);
+  stats->elapsed_us = 3600LL * 1000000LL;
+}
+
+void scd4x_sim_reset_stats() {
+  int64_t now = esp_timer_get_time();
+  portENTER_CRITICAL(&sim_lock);
+  memset(&sim.stats, 0, sizeof(sim.stats));
+  sim.stats_start_us = now;
+  sim.reported_us = now;
+  sim.accounted_us = now;
+  portEXIT_CRITICAL(&sim_lock);
+}
+
+esp_err_t scd4x_sim_init_desc(i2c_dev_t *dev, i2c_port_t port,
+                              gpio_num_t sda_gpio, gpio_num_t scl_gpio) {
+  memset(&sim, 0, sizeof(sim));
+  sim.state = SIM_IDLE;
+  sim.asc = true;
+  sim.asc_persisted = true;
+  sim.rng = 0x5cd4;
+  scd4x_sim_reset_stats();
+
+  dev->port = port;
+  dev->addr = 0x62;
+  dev->cfg.sda_io_num = sda_gpio;
+  dev->cfg.scl_io_num = scl_gpio;
+  ESP_LOGW(TAG, "Using simulated SCD41, clock error %d ppm",
+           SCD4X_SIM_CLOCK_PPM);
+  return ESP_OK;
+}
+
+esp_err_t scd4x_sim_start_periodic_measurement(i2c_dev_t *dev) {
+  esp_err_t err = command(0, 0, false);
+  if (err == ESP_OK) {
+    start_measurement(SIM_PERIODIC, SIM_PERIODIC_US);
+  }
+  return err;
+}
+
+esp_err_t scd4x_sim_start_low_power_periodic_measurement(i2c_dev_t *dev) {
+  esp_err_t err = command(0, 0, false);
+  if (err == ESP_OK) {
+    start_measurement(SIM_LOW_POWER, SIM_LOW_POWER_US);
+  }
+  return err;
+}
+
+esp_err_t scd4x_sim_stop_periodic_measurement(i2c_dev_t *dev) {
+  int64_t now = esp_timer_get_time();
+  update(now);
+  bus_transfer(3);
+  portENTER_CRITICAL(&sim_lock);
+  if (sim.state == SIM_PERIODIC || sim.state == SIM_LOW_POWER) {
+    sim.state = SIM_IDLE;
+  }
+  sim.stopped_us = now + SIM_EXEC_STOP_MS * 1000LL;
+  portEXIT_CRITICAL(&sim_lock);
+  return ESP_OK;
+}
+
+esp_err_t scd4x_sim_measure_single_shot(i2c_dev_t *dev) {
+  esp_err_t err = command(0, 0, false);
+  if (err == ESP_OK) {
+    start_measurement(SIM_SHOT, SIM_SINGLE_SHOT_US);
+  }
+  return err;
+}
+
+esp_err_t scd4x_sim_get_data_ready_status(i2c_dev_t *dev, bool *data_ready) {
+  // Data ready may be polled while a single shot is running
+  esp_err_t err = command(0, SIM_EXEC_DEFAULT_MS, true);
+  if (err != ESP_OK) {
+    return err;
+  }
+  response(1);
+  portENTER_CRITICAL(&sim_lock);
+  sim.stats.ready_polls++;
+  *data_ready = sim.ready;
+  portEXIT_CRITICAL(&sim_lock);
+  return ESP_OK;
+}
+
+esp_err_t scd4x_sim_read_measurement(i2c_dev_t *dev, uint16_t *co2,
+                                     float *temperature, float *humidity) {
+  esp_err_t err = command(0, SIM_EXEC_DEFAULT_MS, true);
+  if (err != ESP_OK) {
+    return err;
+  }
+  response(3);
+
+  // A slow indoor drift with some noise
+  uint32_t phase = sim.stats.samples % 720;
+  int32_t drift = (phase < 360) ? phase : 720 - phase;
+  *co2 = (uint16_t)(450 + drift + next_random(20) + sim.offset);
+  *temperature = 21.5f + next_random(50) / 100.0f;
+  *humidity = 40.0f + next_random(200) / 100.0f;
+
+  portENTER_CRITICAL(&sim_lock);
+  sim.ready = false;
+  sim.stats.samples_read++;
+  portEXIT_CRITICAL(&sim_lock);
+  return ESP_OK;
+}
+
+esp_err_t scd4x_sim_get_automatic_self_calibration(i2c_dev_t *dev,
+                                                   bool *enabled) {
+  esp_err_t err = command(0, SIM_EXEC_DEFAULT_MS, false);
+  if (err == ESP_OK) {
+    response(1);
+    *enabled = sim.asc;
+  }
+  return err;
+}
+
+esp_err_t scd4x_sim_set_automatic_self_calibration(i2c_dev_t *dev,
+                                                   bool enabled) {
+  esp_err_t err = command(1, SIM_EXEC_DEFAULT_MS, false);
+  if (err == ESP_OK) {
+    sim.asc = enabled;
+  }
+  return err;
+}
+
+esp_err_t scd4x_sim_persist_settings(i2c_dev_t *dev) {
+  esp_err_t err = command(0, SIM_EXEC_PERSIST_MS, false);
+  if (err == ESP_OK) {
+    sim.asc_persisted = sim.asc;
+  }
+  return err;
+}
+
+esp_err_t scd4x_sim_perform_forced_recalibration(i2c_dev_t *dev,
+                                                 uint16_t target_co2,
+                                                 uint16_t *correction) {
+  esp_err_t err = command(1, SIM_EXEC_FRC_MS, false);
+  if (err != ESP_OK) {
+    return err;
+  }
+  response(1);
+  int16_t delta = (int16_t)(target_co2 - 450);
+  sim.offset = delta;
+  // The sensor reports the correction offset by 0x8000
+  *correction = (uint16_t)(delta + 0x8000);
+  return ESP_OK;
+}
+
+esp_err_t scd4x_sim_perform_self_test(i2c_dev_t *dev, bool *malfunction) {
+  esp_err_t err = command(0, SIM_EXEC_SELF_TEST_MS, false);
+  if (err == ESP_OK) {
+    response(1);
+    *malfunction = false;
+  }
+  return err;
+}
+
+esp_err_t scd4x_sim_perform_factory_reset(i2c_dev_t *dev) {
+  esp_err_t err = command(0, SIM_EXEC_FACTORY_RESET_MS, false);
+  if (err == ESP_OK) {
+    sim.asc = true;
+    sim.asc_persisted = true;
+    sim.offset = 0;
+  }
+  return err;
+}
+
+esp_err_t scd4x_sim_reinit(i2c_dev_t *dev) {
+  esp_err_t err = command(0, SIM_EXEC_REINIT_MS, false);
+  if (err == ESP_OK) {
+    // Settings are reloaded from EEPROM
+    sim.asc = sim.asc_persisted;
+  }
+  return err;
+}
+
+esp_err_t scd4x_sim_get_serial_number(i2c_dev_t *dev, uint16_t *serial0,
+                                      uint16_t *serial1, uint16_t *serial2) {
+  esp_err_t err = command(0, SIM_EXEC_DEFAULT_MS, false);
+  if (err == ESP_OK) {
+    response(3);
+    *serial0 = 0x5ca1;
+    *serial1 = 0xab1e;
+    *serial2 = 0x0041;
+  }
+  return err;
+}
+
+esp_err_t scd4x_sim_get_sensor_variant(i2c_dev_t *dev, uint16_t *variant) {
+  esp_err_t err = command(0, SIM_EXEC_DEFAULT_MS, false);
+  if (err == ESP_OK) {
+    response(1);
+    // Bits 15:12 = 0b0001 identify an SCD41
+    *variant = 0x1440;
+  }
+  return err;
+}
+
+esp_err_t scd4x_sim_wake_up(i2c_dev_t *dev) {
+  // Not acknowledged by the sensor, never fails
+  bus_transfer(3);
+  vTaskDelay(pdMS_TO_TICKS(30));
+  return ESP_OK;
+}
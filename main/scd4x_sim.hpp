@@ -0,0 +1,100 @@
+#pragma once
+
+#include "esp_err.h"
+#include "i2cdev.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Simulated SCD4x sensor
+ *
+ * Stands in for the esp-idf-lib scd4x driver with the same function
+ * signatures. It models the command set, the execution times and the
+ * data-ready behaviour from the datasheet, so the manager loop can run
+ * without hardware. Every call is counted as bus traffic, which gives
+ * comparable figures for different sampling strategies.
+ */
+
+// Sensor clock error in parts per million, positive runs slow
+#define SCD4X_SIM_CLOCK_PPM 3000
+// Bus clock used to estimate transfer time
+#define SCD4X_SIM_BUS_HZ 100000
+
+/**
+ * @brief Accumulated simulator counters
+ */
+struct Scd4xSimStats {
+  int64_t elapsed_us;     // Time since the simulator was initialized
+  uint32_t transactions;  // I2C transfers (a command with readback counts 2)
+  uint32_t nacks;         // Commands rejected in the current sensor state
+  int64_t bus_busy_us;    // Time the bus was clocking data
+  int64_t active_us;      // Time the sensor spent measuring
+  uint32_t samples;       // Measurements completed
+  uint32_t samples_read;  // Measurements read by the host
+  uint32_t ready_polls;   // get_data_ready_status calls
+};
+
+/**
+ * @brief Get the counters, scaled to one hour of operation
+ * @param stats Output, raw counters multiplied by 1 h / elapsed time
+ */
+void scd4x_sim_get_hourly_stats(Scd4xSimStats *stats);
+
+/**
+ * @brief Get the raw counters
+ */
+void scd4x_sim_get_stats(Scd4xSimStats *stats);
+
+void scd4x_sim_reset_stats();
+
+esp_err_t scd4x_sim_init_desc(i2c_dev_t *dev, i2c_port_t port,
+                              gpio_num_t sda_gpio, gpio_num_t scl_gpio);
+esp_err_t scd4x_sim_start_periodic_measurement(i2c_dev_t *dev);
+esp_err_t scd4x_sim_start_low_power_periodic_measurement(i2c_dev_t *dev);
+esp_err_t scd4x_sim_stop_periodic_measurement(i2c_dev_t *dev);
+esp_err_t scd4x_sim_measure_single_shot(i2c_dev_t *dev);
+esp_err_t scd4x_sim_get_data_ready_status(i2c_dev_t *dev, bool *data_ready);
+esp_err_t scd4x_sim_read_measurement(i2c_dev_t *dev, uint16_t *co2,
+                                     float *temperature, float *humidity);
+esp_err_t scd4x_sim_get_automatic_self_calibration(i2c_dev_t *dev,
+                                                   bool *enabled);
+esp_err_t scd4x_sim_set_automatic_self_calibration(i2c_dev_t *dev,
+                                                   bool enabled);
+esp_err_t scd4x_sim_persist_settings(i2c_dev_t *dev);
+esp_err_t scd4x_sim_perform_forced_recalibration(i2c_dev_t *dev,
+                                                 uint16_t target_co2,
+                                                 uint16_t *correction);
+esp_err_t scd4x_sim_perform_self_test(i2c_dev_t *dev, bool *malfunction);
+esp_err_t scd4x_sim_perform_factory_reset(i2c_dev_t *dev);
+esp_err_t scd4x_sim_reinit(i2c_dev_t *dev);
+esp_err_t scd4x_sim_get_serial_number(i2c_dev_t *dev, uint16_t *serial0,
+                                      uint16_t *serial1, uint16_t *serial2);
+esp_err_t scd4x_sim_get_sensor_variant(i2c_dev_t *dev, uint16_t *variant);
+esp_err_t scd4x_sim_wake_up(i2c_dev_t *dev);
+
+#ifdef CONFIG_SCD4X_USE_SIMULATOR
+// Route the driver calls of this translation unit to the simulator, enabled
+// with CONFIG_SCD4X_USE_SIMULATOR in menuconfig
+#define scd4x_init_desc scd4x_sim_init_desc
+#define scd4x_start_periodic_measurement scd4x_sim_start_periodic_measurement
+#define scd4x_start_low_power_periodic_measurement                            \
+  scd4x_sim_start_low_power_periodic_measurement
+#define scd4x_stop_periodic_measurement scd4x_sim_stop_periodic_measurement
+#define scd4x_measure_single_shot scd4x_sim_measure_single_shot
+#define scd4x_get_data_ready_status scd4x_sim_get_data_ready_status
+#define scd4x_read_measurement scd4x_sim_read_measurement
+#define scd4x_get_automatic_self_calibration                                   \
+  scd4x_sim_get_automatic_self_calibration
+#define scd4x_set_automatic_self_calibration                                   \
+  scd4x_sim_set_automatic_self_calibration
+#define scd4x_persist_settings scd4x_sim_persist_settings
+#define scd4x_perform_forced_recalibration                                     \
+  scd4x_sim_perform_forced_recalibration
+#define scd4x_perform_self_test scd4x_sim_perform_self_test
+#define scd4x_perform_factory_reset scd4x_sim_perform_factory_reset
+#define scd4x_reinit scd4x_sim_reinit
+#define scd4x_get_serial_number scd4x_sim_get_serial_number
+#define scd4x_get_sensor_variant scd4x_sim_get_sensor_variant
+#define scd4x_wake_up scd4x_sim_wake_up
+#endif
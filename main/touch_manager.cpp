@@ -1,39 +1,52 @@
 #include "touch_manager.hpp"
 #include "common_data.hpp"
+#include "data_bus.hpp"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "hal/touch_sens_types.h"
+#include "ui_events.hpp"
 
 static const char *TAG = "TouchManager";
 
 #define TOUCH_BUTTON_4_CHAN_ID 4
 #define BUTTON_GPIO_0 GPIO_NUM_0
 
+// Settle time after a GPIO0 edge before sampling the level
+#define BUTTON_DEBOUNCE_MS 20
+
 // Callbacks
 static bool touch_on_active_callback(touch_sensor_handle_t sens_handle,
                                      const touch_active_event_data_t *event,
                                      void *user_ctx) {
-  DeviceStatus status = global_data.getStatus();
+  BaseType_t woken = pdFALSE;
   if (event->chan_id == TOUCH_BUTTON_4_CHAN_ID) {
-    status.touch_4 = true;
+    global_data.setTouch4(true);
     ESP_EARLY_LOGI(TAG, "Touch 4 Active");
+    ui_events.postFromISR(UI_EVENT_BUTTON, UI_BUTTON_TOUCH_4, true, &woken);
+    if (data_bus.publishFromISR(TOPIC_INPUT, 1, UI_BUTTON_TOUCH_4)) {
+      woken = pdTRUE;
+    }
   }
-  global_data.setStatus(status);
-  return false;
+  return woken == pdTRUE;
 }
 
 static bool touch_on_inactive_callback(touch_sensor_handle_t sens_handle,
                                        const touch_inactive_event_data_t *event,
                                        void *user_ctx) {
-  DeviceStatus status = global_data.getStatus();
+  BaseType_t woken = pdFALSE;
   if (event->chan_id == TOUCH_BUTTON_4_CHAN_ID) {
-    status.touch_4 = false;
+    global_data.setTouch4(false);
     ESP_EARLY_LOGI(TAG, "Touch 4 Inactive");
+    ui_events.postFromISR(UI_EVENT_BUTTON, UI_BUTTON_TOUCH_4, false, &woken);
+    if (data_bus.publishFromISR(TOPIC_INPUT, 0, UI_BUTTON_TOUCH_4)) {
+      woken = pdTRUE;
+    }
   }
-  global_data.setStatus(status);
-  return false;
+  return woken == pdTRUE;
 }
 
 TouchManager::TouchManager() {}
@@ -43,8 +56,10 @@ TouchManager::~TouchManager() {
     touch_sensor_disable(sens_handle);
     touch_sensor_del_controller(sens_handle);
   }
-  if (button_task_handle) {
-    vTaskDelete(button_task_handle);
+  gpio_isr_handler_remove(BUTTON_GPIO_0);
+  if (debounce_timer) {
+    esp_timer_stop(debounce_timer);
+    esp_timer_delete(debounce_timer);
   }
 }
 
@@ -83,8 +98,25 @@ esp_err_t TouchManager::init() {
   btn_cfg.pull_up_en = GPIO_PULLUP_ENABLE;
   gpio_config(&btn_cfg);
 
-  // Start Button Task
-  xTaskCreate(button_task, "button_task", 4096, NULL, 5, &button_task_handle);
+  // Button edges are handled by a level interrupt and a debounce timer,
+  // no task is needed
+  esp_timer_create_args_t timer_args = {};
+  timer_args.callback = debounce_callback;
+  timer_args.arg = this;
+  timer_args.name = "btn_debounce";
+  ESP_ERROR_CHECK(esp_timer_create(&timer_args, &debounce_timer));
+
+  button_pressed = (gpio_get_level(BUTTON_GPIO_0) == 0);
+  global_data.setTouch5(button_pressed);
+
+  esp_err_t isr_err = gpio_install_isr_service(0);
+  if (isr_err != ESP_OK && isr_err != ESP_ERR_INVALID_STATE) {
+    ESP_LOGE(TAG, "GPIO ISR service failed: %s", esp_err_to_name(isr_err));
+    return isr_err;
+  }
+  ESP_ERROR_CHECK(gpio_isr_handler_add(BUTTON_GPIO_0, button_isr, this));
+  armButton(button_pressed);
+  ESP_ERROR_CHECK(esp_sleep_enable_gpio_wakeup());
 
   // 3. Configure Filter
   touch_sensor_filter_config_t filter_cfg =
@@ -160,32 +192,35 @@ esp_err_t TouchManager::start() {
   return touch_sensor_start_continuous_scanning(sens_handle);
 }
 
-void TouchManager::button_task(void *arg) {
-  bool last_pressed = false;
-  // Initial state check
-  int level = gpio_get_level(BUTTON_GPIO_0);
-  last_pressed = (level == 0);
-  // Sync initial state
-  DeviceStatus status = global_data.getStatus();
-  status.touch_5 = last_pressed;
-  global_data.setStatus(status);
-
-  while (1) {
-    level = gpio_get_level(BUTTON_GPIO_0);
-    bool pressed = (level == 0);
-
-    if (pressed != last_pressed) {
-      status = global_data.getStatus();
-      status.touch_5 = pressed;
-      global_data.setStatus(status);
-      if (pressed) {
-        ESP_LOGI(TAG, "Touch 5 (Button) Active");
-      } else {
-        ESP_LOGI(TAG, "Touch 5 (Button) Inactive");
-      }
-      last_pressed = pressed;
-    }
+void IRAM_ATTR TouchManager::button_isr(void *arg) {
+  TouchManager *self = (TouchManager *)arg;
+
+  // Mask the level interrupt until the debounce timer has sampled the pin,
+  // otherwise it would keep firing while the level holds
+  gpio_intr_disable(BUTTON_GPIO_0);
+  self->button_edge_us = esp_timer_get_time();
+  esp_timer_start_once(self->debounce_timer, BUTTON_DEBOUNCE_MS * 1000);
+}
+
+void TouchManager::debounce_callback(void *arg) {
+  TouchManager *self = (TouchManager *)arg;
+  bool pressed = (gpio_get_level(BUTTON_GPIO_0) == 0);
 
-    vTaskDelay(pdMS_TO_TICKS(50));
+  if (pressed != self->button_pressed) {
+    self->button_pressed = pressed;
+    global_data.setTouch5(pressed);
+    ui_events.postButton(UI_BUTTON_GPIO_0, pressed, self->button_edge_us);
+    data_bus.publish(TOPIC_INPUT, pressed ? 1 : 0, UI_BUTTON_GPIO_0);
+    ESP_LOGI(TAG, "Touch 5 (Button) %s", pressed ? "Active" : "Inactive");
   }
-}
\ No newline at end of file
+
+  armButton(pressed);
+}
+
+void TouchManager::armButton(bool pressed) {
+  // Trigger on the opposite level so the next press or release fires. The
+  // same level also wakes the chip from light sleep.
+  gpio_wakeup_enable(BUTTON_GPIO_0,
+                     pressed ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+  gpio_intr_enable(BUTTON_GPIO_0);
+}
@@ -2,6 +2,7 @@
 
 #include "driver/touch_sens.h"
 #include "esp_err.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
@@ -18,6 +19,11 @@ private:
   touch_sensor_handle_t sens_handle = NULL;
   touch_channel_handle_t chan_handle_4 = NULL; // For GPIO 4
 
-  TaskHandle_t button_task_handle = NULL;
-  static void button_task(void *arg);
+  // GPIO0 button: level interrupt plus one-shot debounce timer
+  esp_timer_handle_t debounce_timer = NULL;
+  volatile int64_t button_edge_us = 0; // Written by the ISR
+  bool button_pressed = false;
+  static void button_isr(void *arg);
+  static void debounce_callback(void *arg);
+  void armButton(bool pressed);
 };
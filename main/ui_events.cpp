@@ -0,0 +1,55 @@
+#include "ui_events.hpp"
+#include "esp_timer.h"
+
+static UiEvent make_event(UiEventType type, uint8_t button, bool pressed,
+                          int64_t time_us) {
+  UiEvent event = {};
+  event.type = type;
+  event.button = button;
+  event.pressed = pressed;
+  event.time_us = time_us;
+  return event;
+}
+
+UiEventQueue::UiEventQueue() {
+  queue = xQueueCreate(UI_EVENT_QUEUE_LEN, sizeof(UiEvent));
+}
+
+bool UiEventQueue::post(UiEventType type, uint8_t button, bool pressed) {
+  UiEvent event = make_event(type, button, pressed, esp_timer_get_time());
+  return xQueueSend(queue, &event, 0) == pdTRUE;
+}
+
+bool UiEventQueue::postWait(UiEventType type) {
+  UiEvent event = make_event(type, 0, false, esp_timer_get_time());
+  return xQueueSend(queue, &event, pdMS_TO_TICKS(UI_EVENT_WAIT_TIMEOUT_MS)) ==
+         pdTRUE;
+}
+
+bool UiEventQueue::postButton(uint8_t button, bool pressed, int64_t time_us) {
+  UiEvent event = make_event(UI_EVENT_BUTTON, button, pressed, time_us);
+  return xQueueSend(queue, &event, 0) == pdTRUE;
+}
+
+bool UiEventQueue::postCommand(uint8_t command, int32_t err, int32_t value) {
+  UiEvent event = make_event(UI_EVENT_COMMAND, 0, false, esp_timer_get_time());
+  event.command = command;
+  event.err = err;
+  event.value = value;
+  return xQueueSend(queue, &event,
+                    pdMS_TO_TICKS(UI_EVENT_COMMAND_TIMEOUT_MS)) == pdTRUE;
+}
+
+bool UiEventQueue::postFromISR(UiEventType type, uint8_t button, bool pressed,
+                               BaseType_t *higher_priority_task_woken) {
+  UiEvent event = make_event(type, button, pressed, esp_timer_get_time());
+  return xQueueSendFromISR(queue, &event, higher_priority_task_woken) ==
+         pdTRUE;
+}
+
+bool UiEventQueue::receive(UiEvent &event, TickType_t timeout) {
+  return xQueueReceive(queue, &event, timeout) == pdTRUE;
+}
+
+// Instantiate global object
+UiEventQueue ui_events;
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include <stdint.h>
+
+// Depth of the UI event queue
+#define UI_EVENT_QUEUE_LEN 16
+// How long a command result waits for room in a full queue
+#define UI_EVENT_COMMAND_TIMEOUT_MS 500
+// How long a notification that must not be lost waits for room
+#define UI_EVENT_WAIT_TIMEOUT_MS 500
+
+enum UiEventType {
+  UI_EVENT_BUTTON,  // Button edge, see UiButton
+  UI_EVENT_SENSOR,  // New CO2/temperature/humidity sample
+  UI_EVENT_BATTERY, // Battery voltage changed
+  UI_EVENT_TICK,    // Clock second tick
+  UI_EVENT_COMMAND, // Sensor command finished
+  UI_EVENT_BOOK,    // Book pagination finished
+};
+
+enum UiButton {
+  UI_BUTTON_TOUCH_4, // Touch pad on GPIO 4
+  UI_BUTTON_GPIO_0,  // Boot button, shown as touch 5
+};
+
+/**
+ * @brief Event delivered to the UI task
+ */
+struct UiEvent {
+  UiEventType type;
+  uint8_t button; // UiButton, for UI_EVENT_BUTTON
+  bool pressed;   // New button state, for UI_EVENT_BUTTON
+  int64_t time_us;
+  uint8_t command; // Scd4xCommandType, for UI_EVENT_COMMAND
+  int32_t err;     // esp_err_t, for UI_EVENT_COMMAND
+  int32_t value;   // Command specific result, for UI_EVENT_COMMAND
+};
+
+/**
+ * @brief Queue feeding the UI task with input and data notifications
+ *
+ * Producers post typed events when something changes, so the UI task can
+ * block instead of polling shared state.
+ */
+class UiEventQueue {
+public:
+  UiEventQueue();
+
+  // Post from task context, drops the event if the queue is full
+  bool post(UiEventType type, uint8_t button = 0, bool pressed = false);
+
+  // Post from task context, waiting up to UI_EVENT_WAIT_TIMEOUT_MS for room
+  bool postWait(UiEventType type);
+
+  // Post a button edge with the time it happened at the source
+  bool postButton(uint8_t button, bool pressed, int64_t time_us);
+
+  // Post the outcome of a sensor command, waiting up to
+  // UI_EVENT_COMMAND_TIMEOUT_MS for room since results must not be lost
+  bool postCommand(uint8_t command, int32_t err, int32_t value);
+
+  // Post from an ISR or callback running in interrupt context
+  bool postFromISR(UiEventType type, uint8_t button, bool pressed,
+                   BaseType_t *higher_priority_task_woken);
+
+  // Wait for the next event
+  bool receive(UiEvent &event, TickType_t timeout);
+
+private:
+  QueueHandle_t queue;
+};
+
+// Global instance
+extern UiEventQueue ui_events;
@@ -1,4 +1,5 @@
 #include "ui_manager.hpp"
+#include "data_bus.hpp"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -7,6 +8,7 @@
 #include "scd4x_manager.hpp"
 #include "storage_manager.h"
 #include "ui_assets.hpp"
+#include "ui_events.hpp"
 #include <stdio.h>
 #include <time.h>
 
@@ -19,57 +21,120 @@
 
 static const char *TAG = "UIManager";
 
+// Reader book, which the build stores block-compressed in the memory mapped
+// book partition. A book.bkz or book.txt put onto LittleFS is read when the
+// partition holds none. The page index always lives on LittleFS.
+#define READER_BOOK_NAME "book.bkz"
+#define READER_BKZ_PATH "/littlefs/" READER_BOOK_NAME
+#define READER_TEXT_PATH "/littlefs/book.txt"
+#define READER_INDEX_PATH "/littlefs/book" BOOK_INDEX_SUFFIX
+
+// Reader layout for FreeSans7pt7b on the 296x128 panel
+#define READER_MAX_LINES 7
+#define READER_LINE_WIDTH 296
+
+// Idle time after a frame before neighbour pages are prerendered
+#define READER_PRERENDER_DELAY_MS 20
+
 // Menu Items
 static const char *menu_items[] = {
     "Back",   "Refresh", "SCD41 Toggle ASC", "SCD41 FRC 430ppm",
     "Reboot", "Reader",  "Factory Reset"};
 static const int menu_item_count = 7;
 
+// Touch 4 steps through menus and pages, holding it repeats
+static const GestureTimings touch4_timings = {
+    .double_click_us = 0,
+    .hold_us = 600000,
+    .long_hold_us = 0,
+    .repeat_us = 300000,
+};
+
+// Button 5 selects, holding it in the reader exits to the menu
+static const GestureTimings btn5_timings = {
+    .double_click_us = 0,
+    .hold_us = 1000000,
+    .long_hold_us = 0,
+    .repeat_us = 0,
+};
+
 // Compatibility defines
 #define GxEPD_BLACK GFX_BLACK
 #define GxEPD_WHITE GFX_WHITE
 
-#ifndef pgm_read_byte
-#define pgm_read_byte(addr) (*(const unsigned char *)(addr))
-#endif
-#ifndef pgm_read_word
-#define pgm_read_word(addr) (*(const unsigned short *)(addr))
-#endif
-#ifndef pgm_read_dword
-#define pgm_read_dword(addr) (*(const unsigned long *)(addr))
-#endif
-
-// Helper for GFXGlyph pointer math (from Adafruit_GFX.cpp)
-#if !defined(__INT_MAX__) || (__INT_MAX__ > 0xFFFF)
-#define pgm_read_pointer(addr) ((void *)pgm_read_dword(addr))
-#else
-#define pgm_read_pointer(addr) ((void *)pgm_read_word(addr))
-#endif
-
-inline GFXglyph *pgm_read_glyph_ptr(const GFXfont *gfxFont, uint8_t c) {
-#ifdef __AVR__
-  return &(((GFXglyph *)pgm_read_pointer(&gfxFont->glyph))[c]);
-#else
-  // expression in __AVR__ section may generate "dereferencing type-punned
-  // pointer will break strict-aliasing rules" warning In fact, on other
-  // platforms (such as STM32) there is no need to do this pointer magic as
-  // program memory may be read just like Data memory !
-  return gfxFont->glyph + c;
-#endif
-}
-
 UIManager::UIManager(Adafruit_SSD1680 *display, StorageManager *storageManager,
                      Scd4xManager *scd4xManager)
     : display(display), storageManager(storageManager),
       scd4xManager(scd4xManager), current_state(STATE_HOME),
-      selected_menu_index(0), asc_enabled(false), current_page_index(0) {
-  btn4 = {false, false};
-  btn5 = {false, false};
-  btn5_press_start_time = 0;
-  btn5_hold_triggered = false;
+      selected_menu_index(0), asc_enabled(false),
+      book(&FreeSans7pt7b, READER_MAX_LINES, READER_LINE_WIDTH),
+      reader_offset(0), reader_turned(false), prerender_pending(false),
+      book_complete(false), legacy_page(-1), rendered_state(STATE_HOME),
+      screen_valid(false), home_layer(nullptr), home_layer_valid(false),
+      sensor_submitted(0), sensor_completed(0), sensor_pending(0),
+      asc_known(false),
+      co2_text(292, 122, &FreeSans9pt7b, ALIGN_RIGHT),
+      temp_text(292, 82, NULL, ALIGN_RIGHT),
+      hum_text(292, 91, NULL, ALIGN_RIGHT),
+      alt_text(292, 100, NULL, ALIGN_RIGHT),
+      time_text(292, 78, &FreeSans18pt7b, ALIGN_RIGHT),
+      battery_text(235, 44, NULL), touch4_text(34, 115, NULL),
+      touch5_text(84, 115, NULL),
+      check_icon(181, 108, image_check_bits, 12, 16),
+      menu_title(10, 20, &FreeSans9pt7b),
+      menu_status(292, 20, &FreeSans7pt7b, ALIGN_RIGHT),
+      menu_list(20, 38, 15, &FreeSans7pt7b), render_count(0),
+      render_total_us(0), clock_timer(nullptr), clock_running(false),
+      touch4_gestures(touch4_timings), btn5_gestures(btn5_timings) {
+  buildScreens();
+}
+
+void UIManager::buildScreens() {
+  home_screen.add(&co2_text);
+  home_screen.add(&temp_text);
+  home_screen.add(&hum_text);
+  home_screen.add(&alt_text);
+  home_screen.add(&time_text);
+  home_screen.add(&battery_text);
+  home_screen.add(&touch4_text);
+  home_screen.add(&touch5_text);
+  home_screen.add(&check_icon);
+
+  menu_title.setText("Menu");
+  menu_list.setItemCount(menu_item_count);
+  for (int i = 0; i < menu_item_count; i++) {
+    menu_list.setItem(i, menu_items[i]);
+  }
+  menu_status_text[0] = '\0';
+  menu_screen.add(&menu_title);
+  menu_screen.add(&menu_status);
+  menu_screen.add(&menu_list);
+}
+
+void UIManager::dataCallback(const DataSample &sample, void *ctx) {
+  ui_events.post(sample.topic == TOPIC_BATTERY ? UI_EVENT_BATTERY
+                                               : UI_EVENT_SENSOR);
 }
 
 void UIManager::start() {
+  // Temperature and humidity are published together with every CO2 sample,
+  // so CO2 alone is enough to wake the UI. The battery is shown with two
+  // decimals, smaller changes are not worth a redraw.
+  DataFilter sensor_filter = {DATA_TOPIC_BIT(TOPIC_CO2), 0, nullptr, nullptr};
+  data_bus.subscribeCallback(sensor_filter, dataCallback, this);
+  DataFilter battery_filter = {DATA_TOPIC_BIT(TOPIC_BATTERY), 0.01f, nullptr,
+                               nullptr};
+  data_bus.subscribeCallback(battery_filter, dataCallback, this);
+
+  esp_timer_create_args_t timer_args = {};
+  timer_args.callback = clockTickCallback;
+  timer_args.arg = this;
+  timer_args.name = "ui_clock";
+  if (esp_timer_create(&timer_args, &clock_timer) != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to create clock timer");
+    clock_timer = nullptr;
+  }
+
   xTaskCreate(taskEntry, "ui_task", 4096, this, 5, NULL);
 }
 
@@ -78,18 +143,7 @@ void UIManager::taskEntry(void *param) {
   instance->loop();
 }
 
-void UIManager::updateButtonState(ButtonState &btn, bool current) {
-  btn.pressed = (current && !btn.last_state);
-  btn.last_state = current;
-}
-
-void UIManager::renderHome(const DeviceStatus &status,
-                           const struct tm *timeinfo) {
-  display->clearBuffer();
-  display->setRotation(3); // Landscape (296x128)
-  display->setTextColor(GxEPD_BLACK);
-  display->setTextWrap(false);
-
+void UIManager::renderHomeStatic() {
   // CO2 Label
   display->setFont(NULL); // Default font
   display->setCursor(196, 114);
@@ -99,15 +153,6 @@ void UIManager::renderHome(const DeviceStatus &status,
   display->setCursor(208, 122);
   display->print("2");
 
-  // ppm Value
-  display->setFont(&FreeSans9pt7b);
-  char co2_buf[16];
-  snprintf(co2_buf, sizeof(co2_buf), "%dppm", status.co2_ppm);
-  display->printRightAligned(292, 122, co2_buf);
-
-  // display->setCursor(262, 122);
-  // display->print("ppm");
-
   // Environmental Labels (T, H, A)
   display->setFont(NULL);
   display->setCursor(238, 82);
@@ -117,33 +162,8 @@ void UIManager::renderHome(const DeviceStatus &status,
   display->setCursor(238, 100);
   display->print("A:");
 
-  // Environmental Values
-  char val_buf[16];
-  snprintf(val_buf, sizeof(val_buf), "%.2fC", status.temperature);
-  display->printRightAligned(292, 82, val_buf);
-
-  snprintf(val_buf, sizeof(val_buf), "%.2f%%", status.humidity);
-  display->printRightAligned(292, 91, val_buf);
-
-  snprintf(val_buf, sizeof(val_buf), "%+.2fm", status.altitude);
-  display->printRightAligned(292, 100, val_buf);
-
-  // Time
-  char time_str[16];
-  strftime(time_str, sizeof(time_str), "%H:%M:%S", timeinfo);
-  display->setFont(&FreeSans18pt7b);
-  display->printRightAligned(292, 78, time_str);
-
   // Bitmaps
   display->drawBitmap(40, 12, image_Layer_8_bits, 18, 19, GxEPD_BLACK);
-
-  // Battery Voltage
-  display->setFont(NULL);
-  display->setCursor(235, 44);
-  char bat_buf[10];
-  snprintf(bat_buf, sizeof(bat_buf), "%.2fV", status.battery_voltage);
-  display->print(bat_buf);
-
   display->drawBitmap(267, 37, image_battery_50_bits, 24, 16, GxEPD_BLACK);
   display->drawBitmap(276, 5, image_choice_bullet_on_bits, 15, 16, GxEPD_BLACK);
   display->drawBitmap(233, 1, image_ButtonUp_bits, 7, 4, GxEPD_BLACK);
@@ -151,62 +171,107 @@ void UIManager::renderHome(const DeviceStatus &status,
   display->drawBitmap(230, 6, image_stats_bits, 13, 11, GxEPD_BLACK);
   display->drawBitmap(98, 4, image_menu_settings_sliders_two_bits, 14, 16,
                       GxEPD_BLACK);
-  display->drawBitmap(181, 108, image_check_bits, 12, 16, GxEPD_BLACK);
 
-  // Touch Status
-  display->setFont(NULL);
+  // Touch Status labels
   display->setCursor(10, 115);
   display->print("T4: ");
-  display->print(status.touch_4 ? "1" : "0");
-
   display->setCursor(60, 115);
   display->print("T5: ");
-  display->print(status.touch_5 ? "1" : "0");
 }
 
-void UIManager::renderMenu() {
-  display->clearBuffer();
-  display->setRotation(3);
+void UIManager::renderHome(const DeviceStatus &status,
+                           const struct tm *timeinfo, bool entering) {
+  display->setRotation(3); // Landscape (296x128)
   display->setTextColor(GxEPD_BLACK);
   display->setTextWrap(false);
 
-  // Title
-  display->setFont(&FreeSans9pt7b);
-  display->setCursor(10, 20);
-  display->print("Menu");
+  // Labels and icons never change, start from the cached background
+  if (entering) {
+#if UI_USE_STATIC_LAYERS
+    if (!home_layer) {
+      home_layer = display->allocLayer();
+      home_layer_valid = false;
+    }
+    if (home_layer && home_layer_valid) {
+      display->loadLayer(home_layer);
+    } else {
+      display->clearBuffer();
+      renderHomeStatic();
+      if (home_layer) {
+        display->saveLayer(home_layer);
+        home_layer_valid = true;
+      }
+    }
+    home_screen.setBackground(home_layer_valid ? home_layer : nullptr);
+#else
+    display->clearBuffer();
+    renderHomeStatic();
+#endif
+    home_screen.invalidateAll();
+  }
 
-  // Items
-  display->setFont(&FreeSans7pt7b);
-  int start_y = 38;
-  int line_height = 15;
+  // Setters only invalidate widgets whose text actually changed
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%dppm", status.co2_ppm);
+  co2_text.setText(buf);
 
-  for (int i = 0; i < menu_item_count; i++) {
-    display->setCursor(20, start_y + (i * line_height));
+  snprintf(buf, sizeof(buf), "%.2fC", status.temperature);
+  temp_text.setText(buf);
+  snprintf(buf, sizeof(buf), "%.2f%%", status.humidity);
+  hum_text.setText(buf);
+  snprintf(buf, sizeof(buf), "%+.2fm", status.altitude);
+  alt_text.setText(buf);
 
-    if (i == selected_menu_index) {
-      display->print("> "); // Cursor
-    } else {
-      display->print("  ");
-    }
+  strftime(buf, sizeof(buf), "%H:%M:%S", timeinfo);
+  time_text.setText(buf);
 
-    if (i == 2) { // ASC Item
-      char asc_buf[32];
-      snprintf(asc_buf, sizeof(asc_buf), "ASC: %s", asc_enabled ? "ON" : "OFF");
-      display->print(asc_buf);
-    } else {
-      display->print(menu_items[i]);
-    }
+  snprintf(buf, sizeof(buf), "%.2fV", status.battery_voltage);
+  battery_text.setText(buf);
+
+  // Touch Status values, right after the "T4: " / "T5: " labels
+  touch4_text.setText(status.touch_4 ? "1" : "0");
+  touch5_text.setText(status.touch_5 ? "1" : "0");
+
+  UiRect area = home_screen.render(display);
+  ESP_LOGD(TAG, "Home dirty region %d,%d %dx%d", area.x, area.y, area.w,
+           area.h);
+}
+
+void UIManager::renderMenu(bool entering) {
+  display->setRotation(3);
+  display->setTextColor(GxEPD_BLACK);
+  display->setTextWrap(false);
+
+  if (entering) {
+    display->clearBuffer();
+    menu_screen.invalidateAll();
   }
+
+  char asc_buf[32];
+  snprintf(asc_buf, sizeof(asc_buf), "ASC: %s",
+           asc_known ? (asc_enabled ? "ON" : "OFF") : "...");
+  menu_list.setItem(2, asc_buf); // ASC Item
+  menu_list.setSelected(selected_menu_index);
+
+  // Sensor commands run in the background, show that one is in flight
+  menu_status.setText(sensor_pending > 0 ? "Working..." : menu_status_text);
+
+  UiRect area = menu_screen.render(display);
+  ESP_LOGD(TAG, "Menu dirty region %d,%d %dx%d", area.x, area.y, area.w,
+           area.h);
 }
 
 void UIManager::saveProgress() {
+  // A saved offset supersedes the page number of older versions
+  legacy_page = -1;
   nvs_handle_t my_handle;
   esp_err_t err = nvs_open("reader", NVS_READWRITE, &my_handle);
   if (err == ESP_OK) {
-    nvs_set_i32(my_handle, "page_idx", current_page_index);
+    nvs_set_u32(my_handle, "page_off", reader_offset);
+    nvs_erase_key(my_handle, "page_idx");
     nvs_commit(my_handle);
     nvs_close(my_handle);
-    ESP_LOGI(TAG, "Saved page index: %d", current_page_index);
+    ESP_LOGI(TAG, "Saved page offset: %lu", reader_offset);
   } else {
     ESP_LOGE(TAG, "Error (%s) opening NVS handle", esp_err_to_name(err));
   }
@@ -216,324 +281,524 @@ void UIManager::loadProgress() {
   nvs_handle_t my_handle;
   esp_err_t err = nvs_open("reader", NVS_READONLY, &my_handle);
   if (err == ESP_OK) {
-    int32_t saved_page = 0;
-    err = nvs_get_i32(my_handle, "page_idx", &saved_page);
+    uint32_t saved_offset = 0;
+    err = nvs_get_u32(my_handle, "page_off", &saved_offset);
     if (err == ESP_OK) {
-      current_page_index = saved_page;
-      ESP_LOGI(TAG, "Loaded page index: %d", current_page_index);
+      reader_offset = saved_offset;
+      ESP_LOGI(TAG, "Loaded page offset: %lu", reader_offset);
+    } else {
+      // Older versions saved a page number, it is mapped to an offset once
+      // the book is paginated that far
+      int32_t saved_page = 0;
+      if (nvs_get_i32(my_handle, "page_idx", &saved_page) == ESP_OK &&
+          saved_page >= 0) {
+        legacy_page = saved_page;
+        ESP_LOGI(TAG, "Loaded page index %ld, migrating", legacy_page);
+      }
     }
     nvs_close(my_handle);
   }
 }
 
-// Helper to paginate based on screen lines with word wrap, ignoring single
-// Helper to get text width using FreeSans7pt7b
-int getTextWidth(const std::string &text) {
-  int width = 0;
-  const GFXfont *gfxFont = &FreeSans7pt7b;
-  uint8_t first = pgm_read_byte(&gfxFont->first);
-  uint8_t last = pgm_read_byte(&gfxFont->last);
-
-  for (char c : text) {
-    if (c >= first && c <= last) {
-      GFXglyph *glyph = pgm_read_glyph_ptr(gfxFont, c - first);
-      width += pgm_read_byte(&glyph->xAdvance);
-    }
+void UIManager::migrateProgress() {
+  uint32_t offset;
+  if (legacy_page < 0 || !book.isOpen() ||
+      !book.getPageOffset(legacy_page, offset)) {
+    return;
+  }
+  ESP_LOGI(TAG, "Page index %ld is at offset %lu", legacy_page, offset);
+  reader_offset = offset;
+  saveProgress();
+}
+
+void UIManager::bookReady(void *ctx) {
+  // Runs on the pagination task, the footer can show exact numbers now.
+  // The UI also notices completion on its own if this event is lost.
+  if (!ui_events.postWait(UI_EVENT_BOOK)) {
+    ESP_LOGW(TAG, "UI queue full, book completion not posted");
+  }
+}
+
+bool UIManager::updateBookComplete() {
+  bool complete = book.isOpen() && book.isComplete();
+  if (complete == book_complete) {
+    return false;
   }
-  return width;
+  book_complete = complete;
+  // Every page number can be mapped now
+  migrateProgress();
+  return true;
 }
 
-void UIManager::paginateContent(const std::string &content) {
-  pages.clear();
-  // current_page_index = 0; // Do not reset here
+void UIManager::renderReader() {
+  display->setRotation(3);
+  display->setTextColor(GxEPD_BLACK);
+  display->setTextWrap(true);
 
-  if (content.empty()) {
+  // Open the book if needed. Without a stored index it is paginated in the
+  // background and the saved page can be shown right away.
+  if (!book.isOpen() && !openBook()) {
     return;
   }
 
-  // Visual Parameters for FreeSans7pt7b
-  // 7pt font is smaller.
-  // 128px height / ~11px line height = ~11 lines. Let's try 10.
-  const int MAX_LINES_PER_PAGE = 7;
-  // Width: 296px. Margin ~3-3px. Safe width = 290px.
-  const int MAX_LINE_WIDTH = 296;
-
-  std::string current_page_str;
-  int current_lines = 0;
-  int current_line_width = 0;
-
-  size_t idx = 0;
-  while (idx < content.length()) {
-    // 1. Consume Whitespace & Count Newlines
-    int newlines = 0;
-    while (
-        idx < content.length() &&
-        (content[idx] == ' ' || content[idx] == '\n' || content[idx] == '\r')) {
-      if (content[idx] == '\n')
-        newlines++;
-      idx++;
+  // A page turn to a prerendered page only copies its frame
+  BookPosition pos;
+  book.getPosition(reader_offset, pos);
+  if (reader_turned) {
+    reader_turned = false;
+    const uint8_t *frame = page_cache.lookup(reader_offset, pos);
+    if (frame) {
+      display->loadLayer(frame);
+      return;
     }
+  }
+  drawReaderPage(reader_offset, pos);
+}
 
-    if (idx >= content.length())
-      break; // End of whitespace at end of file
+bool UIManager::openBook() {
+  if (!storageManager) {
+    display->clearBuffer();
+    display->setCursor(10, 50);
+    display->print("Storage Error");
+    return false;
+  }
+  BookSource *source = nullptr;
+  if (book_store.mount() == ESP_OK) {
+    source = book_store.open(READER_BOOK_NAME);
+  }
+  if (source == nullptr) {
+    BkzBookSource *packed = new BkzBookSource(READER_BKZ_PATH);
+    if (packed->valid()) {
+      source = packed;
+    } else {
+      delete packed;
+    }
+  }
+  if (source == nullptr) {
+    source = new FileBookSource(READER_TEXT_PATH);
+  }
+  if (book.open(source, READER_INDEX_PATH, reader_offset, bookReady, this) !=
+      ESP_OK) {
+    display->clearBuffer();
+    display->setCursor(10, 50);
+    display->print("File empty or not found.");
+    return false;
+  }
+  reader_offset = book.getResumeOffset();
+  // A stored index completes the book right away, which also maps an old
+  // page number
+  updateBookComplete();
+  page_cache.init(display);
+  page_cache.clear();
+  return true;
+}
 
-    // 2. Consume Word
-    size_t word_start = idx;
-    while (idx < content.length() && content[idx] != ' ' &&
-           content[idx] != '\n' && content[idx] != '\r') {
-      idx++;
+void UIManager::drawReaderPage(uint32_t offset, const BookPosition &pos) {
+  display->clearBuffer();
+  display->setRotation(3);
+  display->setTextColor(GxEPD_BLACK);
+  display->setTextWrap(true);
+
+  // Content, only the current page is read from the file
+  std::string page;
+  if (book.readPage(offset, page) != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to read page at %lu", offset);
+  }
+  display->setFont(&FreeSans7pt7b); // New serif font
+  display->setCursor(
+      0, 11); // Start closer to top-left but account for baseline (y=15 approx)
+  display->print(page.c_str());
+
+  // Footer: Page X/Y, estimates are marked until pagination is done
+  display->setFont(NULL);
+  char footer[32];
+  snprintf(footer, sizeof(footer), "%s%lu / %s%lu", pos.page_exact ? "" : "~",
+           pos.page, pos.pages_exact ? "" : "~", pos.pages);
+  display->printRightAligned(296, 121, footer);
+}
+
+void UIManager::prerenderReader() {
+  if (current_state != STATE_READER || !book.isOpen()) {
+    prerender_pending = false;
+    return;
+  }
+
+  // Paging forward is the common case, so the next page goes first. The
+  // previous page is only known once pagination got there.
+  uint32_t next = reader_offset;
+  uint32_t prev = reader_offset;
+  bool has_next = book.nextPage(reader_offset, next);
+  bool has_prev = book.previousPage(reader_offset, prev);
+  BookPosition next_pos, prev_pos;
+  if (has_next) {
+    book.getPosition(next, next_pos);
+    has_next = !page_cache.contains(next, next_pos);
+  }
+  if (has_prev) {
+    book.getPosition(prev, prev_pos);
+    has_prev = !page_cache.contains(prev, prev_pos);
+  }
+
+  uint8_t *frame = nullptr;
+  uint32_t offset = 0;
+  BookPosition pos;
+  if (has_next) {
+    offset = next;
+    pos = next_pos;
+    frame = page_cache.prepare(next, next_pos, prev);
+  } else if (has_prev) {
+    offset = prev;
+    pos = prev_pos;
+    frame = page_cache.prepare(prev, prev_pos, next);
+  }
+  if (!frame) {
+    prerender_pending = false;
+    return;
+  }
+
+  int64_t start = esp_timer_get_time();
+  display->beginLayer(frame);
+  drawReaderPage(offset, pos);
+  display->endLayer();
+  ESP_LOGD(TAG, "Prerendered page at %lu in %lld us", offset,
+           esp_timer_get_time() - start);
+}
+
+RefreshQuality UIManager::screenQuality() const {
+  // Pages prefer partial updates with periodic cleanup, menu navigation and
+  // the clock want the fastest update possible
+  if (current_state == STATE_READER) {
+    return REFRESH_BALANCED;
+  }
+  return REFRESH_FAST;
+}
+
+bool UIManager::handleGesture(uint8_t button, const Gesture &gesture) {
+  bool step = (gesture.type == GESTURE_CLICK || gesture.type == GESTURE_HOLD ||
+               gesture.type == GESTURE_REPEAT);
+
+  if (current_state == STATE_HOME) {
+    if (button == UI_BUTTON_GPIO_0 && gesture.type == GESTURE_CLICK) {
+      ESP_LOGI(TAG, "Entering Menu");
+      current_state = STATE_MENU;
+      selected_menu_index = 0;
+      // Fetch ASC status once when entering menu, shown when it arrives
+      asc_known = false;
+      menu_status_text[0] = '\0';
+      submitSensorCommand(SCD4X_CMD_GET_ASC);
+      return true;
     }
-    std::string word = content.substr(word_start, idx - word_start);
-    int word_width = getTextWidth(word);
-
-    // 3. Determine Separator Logic
-    bool is_page_start = current_page_str.empty();
-    int space_width = getTextWidth(" ");
-
-    // Paragraph Break Detection (>1 newline)
-    if (newlines >= 2 && !is_page_start) {
-      // We want a blank line.
-      int cost_lines = (current_line_width > 0) ? 2 : 1;
-
-      if (current_lines + cost_lines >= MAX_LINES_PER_PAGE) {
-        // Page Full
-        pages.push_back(current_page_str);
-        current_page_str.clear();
-        current_lines = 0;
-        current_line_width = 0;
-        // On new page, ignore paragraph break (implicit at top)
-      } else {
-        // Apply Paragraph Break
-        if (current_line_width > 0) {
-          current_page_str += "\n\n";
-          current_lines += 2;
-        } else {
-          current_page_str += "\n";
-          current_lines += 1;
-        }
-        current_line_width = 0;
+  } else if (current_state == STATE_MENU) {
+    if (button == UI_BUTTON_TOUCH_4 && step) {
+      // Cycle Selection, holding scrolls
+      selected_menu_index = (selected_menu_index + 1) % menu_item_count;
+      return true;
+    }
+    if (button == UI_BUTTON_GPIO_0 && gesture.type == GESTURE_CLICK) {
+      // Execute Action
+      if (selected_menu_index == 0) { // Back
+        current_state = STATE_HOME;
+      } else if (selected_menu_index == 1) { // Refresh
+        display->requestCleanRefresh();      // Next draw will be full
+        current_state = STATE_HOME;
+      } else if (selected_menu_index == 2) { // SCD41 Toggle ASC
+        submitSensorCommand(SCD4X_CMD_TOGGLE_ASC);
+      } else if (selected_menu_index == 3) { // SCD41 FRC 430ppm
+        submitSensorCommand(SCD4X_CMD_FRC, 430);
+      } else if (selected_menu_index == 4) { // Reboot
+        esp_restart();
+      } else if (selected_menu_index == 5) { // Reader
+        current_state = STATE_READER;
+        loadProgress(); // Load saved page
+      } else if (selected_menu_index == 6) { // Factory Reset
+        submitSensorCommand(SCD4X_CMD_FACTORY_RESET);
       }
+      return true;
     }
-    // Normal Word Separation (Space or Single Newline -> Space)
-    else if (!is_page_start) {
-      // Check if " " + word fits on current line.
-      if (current_line_width + space_width + word_width > MAX_LINE_WIDTH) {
-        // Wrap to next line
-        if (current_lines + 1 >= MAX_LINES_PER_PAGE) {
-          // Page Full
-          pages.push_back(current_page_str);
-          current_page_str.clear();
-          current_lines = 0;
-          current_line_width = 0;
-        } else {
-          current_page_str += "\n";
-          current_lines++;
-          current_line_width = 0;
+  } else if (current_state == STATE_READER) {
+    if (button == UI_BUTTON_TOUCH_4 && step) { // Next Page
+      uint32_t next;
+      if (book.isOpen() && book.nextPage(reader_offset, next)) {
+        reader_offset = next;
+        reader_turned = true;
+        saveProgress();
+        return true;
+      }
+    } else if (button == UI_BUTTON_GPIO_0) {
+      // Click -> Previous Page, known once pagination got there
+      uint32_t prev;
+      if (gesture.type == GESTURE_CLICK && book.isOpen() &&
+          book.previousPage(reader_offset, prev)) {
+        reader_offset = prev;
+        reader_turned = true;
+        saveProgress();
+        return true;
+      }
+      if (gesture.type == GESTURE_HOLD) {
+        ESP_LOGI(TAG, "Hold detected: Exiting Reader");
+        // Keep an unmigrated page number for the next visit
+        if (legacy_page < 0) {
+          saveProgress();
         }
-      } else {
-        // Fits on line
-        current_page_str += " ";
-        current_line_width += space_width;
+        current_state = STATE_MENU;
+        return true;
       }
-    } else {
-      // Page start
     }
+  }
+  return false;
+}
 
-    // 4. Add Word
-    current_page_str += word;
-    current_line_width += word_width;
+bool UIManager::dispatchGestures() {
+  bool need_redraw = false;
+  int64_t now_us = esp_timer_get_time();
+  GestureRecognizer *recognizers[] = {&touch4_gestures, &btn5_gestures};
+
+  for (uint8_t button = 0; button < 2; button++) {
+    Gesture gesture;
+    while (recognizers[button]->nextGesture(gesture)) {
+      ESP_LOGD(TAG, "Button %d gesture %d, %lld us late", button,
+               gesture.type, now_us - gesture.time_us);
+      need_redraw |= handleGesture(button, gesture);
+    }
   }
+  return need_redraw;
+}
 
-  if (!current_page_str.empty()) {
-    pages.push_back(current_page_str);
+bool UIManager::processGestures() {
+  int64_t now_us = esp_timer_get_time();
+  touch4_gestures.poll(now_us);
+  btn5_gestures.poll(now_us);
+  return dispatchGestures();
+}
+
+void UIManager::sensorDone(const Scd4xResult &result, void *ctx) {
+  int32_t value = 0;
+  if (result.type == SCD4X_CMD_GET_ASC || result.type == SCD4X_CMD_TOGGLE_ASC) {
+    value = result.asc_enabled;
+  } else if (result.type == SCD4X_CMD_FRC) {
+    value = result.correction;
+  }
+  UIManager *self = (UIManager *)ctx;
+  self->sensor_completed++;
+  if (!ui_events.postCommand(result.type, result.err, value)) {
+    ESP_LOGW(TAG, "UI queue full, result of command %d dropped", result.type);
   }
 }
 
-void UIManager::renderReader() {
-  display->clearBuffer();
-  display->setRotation(3);
-  display->setTextColor(GxEPD_BLACK);
-  display->setTextWrap(true);
+void UIManager::submitSensorCommand(Scd4xCommandType type, uint16_t arg) {
+  if (!scd4xManager)
+    return;
 
-  // Load content if needed
-  if (pages.empty()) {
-    if (storageManager) {
-      std::string content = storageManager->readTextFile("/littlefs/book.txt");
-      if (content.empty()) {
-        display->setCursor(10, 50);
-        display->print("File empty or not found.");
-        return;
-      }
-      paginateContent(content);
+  esp_err_t err = ESP_FAIL;
+  switch (type) {
+  case SCD4X_CMD_GET_ASC:
+    err = scd4xManager->getASCStatus(sensorDone, this);
+    break;
+  case SCD4X_CMD_TOGGLE_ASC:
+    err = scd4xManager->toggleASC(sensorDone, this);
+    break;
+  case SCD4X_CMD_FRC:
+    err = scd4xManager->performFRC(arg, sensorDone, this);
+    break;
+  case SCD4X_CMD_FACTORY_RESET:
+    err = scd4xManager->performFactoryReset(sensorDone, this);
+    break;
+  default:
+    break;
+  }
 
-      // Validate loaded page index against new page count
-      if (current_page_index >= pages.size()) {
-        current_page_index = pages.empty() ? 0 : pages.size() - 1;
-      }
+  if (err == ESP_OK) {
+    sensor_submitted++;
+    updateSensorPending();
+  } else {
+    snprintf(menu_status_text, sizeof(menu_status_text), "Busy");
+  }
+}
+
+bool UIManager::updateSensorPending() {
+  // Completion may be counted before the submit returned
+  int32_t pending = (int32_t)(sensor_submitted - sensor_completed.load());
+  if (pending < 0) {
+    pending = 0;
+  }
+  if (pending == sensor_pending) {
+    return false;
+  }
+  sensor_pending = pending;
+  return true;
+}
+
+bool UIManager::handleCommandResult(const UiEvent &event) {
+  updateSensorPending();
+
+  bool ok = (event.err == ESP_OK);
+  switch (event.command) {
+  case SCD4X_CMD_GET_ASC:
+    if (ok) {
+      asc_enabled = event.value;
+      asc_known = true;
+    }
+    break;
+  case SCD4X_CMD_TOGGLE_ASC:
+    if (ok) {
+      asc_enabled = event.value;
+      asc_known = true;
+    }
+    snprintf(menu_status_text, sizeof(menu_status_text), "ASC %s",
+             ok ? "saved" : "failed");
+    break;
+  case SCD4X_CMD_FRC:
+    if (ok) {
+      snprintf(menu_status_text, sizeof(menu_status_text), "FRC %+d ppm",
+               (int)event.value - 0x8000);
     } else {
-      display->setCursor(10, 50);
-      display->print("Storage Error");
-      return;
+      snprintf(menu_status_text, sizeof(menu_status_text), "FRC failed");
     }
+    break;
+  case SCD4X_CMD_FACTORY_RESET:
+    snprintf(menu_status_text, sizeof(menu_status_text), "Reset %s",
+             ok ? "done" : "failed");
+    break;
+  default:
+    break;
   }
+  return current_state == STATE_MENU;
+}
 
-  // Content
-  display->setFont(&FreeSans7pt7b); // New serif font
-  display->setCursor(
-      0, 11); // Start closer to top-left but account for baseline (y=15 approx)
+bool UIManager::handleEvent(const UiEvent &event) {
+  switch (event.type) {
+  case UI_EVENT_COMMAND:
+    return handleCommandResult(event);
+  case UI_EVENT_BUTTON:
+    if (event.button == UI_BUTTON_TOUCH_4) {
+      touch4_gestures.onEdge(event.pressed, event.time_us);
+    } else {
+      btn5_gestures.onEdge(event.pressed, event.time_us);
+    }
+    // The home screen shows the touch indicators
+    return current_state == STATE_HOME;
+  case UI_EVENT_BOOK:
+    // Page numbers in the reader footer are final now
+    return updateBookComplete() && current_state == STATE_READER;
+  case UI_EVENT_SENSOR:
+  case UI_EVENT_BATTERY:
+  case UI_EVENT_TICK:
+    // Only the home screen shows live data
+    return current_state == STATE_HOME;
+  }
+  return false;
+}
 
-  if (current_page_index < pages.size()) {
-    display->print(pages[current_page_index].c_str());
+TickType_t UIManager::gestureTimeout() const {
+  int64_t deadline = touch4_gestures.nextDeadline();
+  int64_t btn5_deadline = btn5_gestures.nextDeadline();
+  if (deadline < 0 || (btn5_deadline >= 0 && btn5_deadline < deadline)) {
+    deadline = btn5_deadline;
+  }
+  if (deadline < 0) {
+    return portMAX_DELAY;
   }
+  int64_t left_us = deadline - esp_timer_get_time();
+  return (left_us > 0) ? pdMS_TO_TICKS(left_us / 1000) + 1 : 0;
+}
 
-  // Footer: Page X/Y
-  display->setFont(NULL);
-  char footer[32];
-  snprintf(footer, sizeof(footer), "%d / %d", current_page_index + 1,
-           (int)pages.size());
-  display->printRightAligned(296, 121, footer);
+void UIManager::clockTickCallback(void *arg) { ui_events.post(UI_EVENT_TICK); }
+
+void UIManager::updateClockTick() {
+  // The clock is only visible on the home screen
+  bool wanted = (current_state == STATE_HOME);
+  if (!clock_timer || wanted == clock_running)
+    return;
+
+  if (wanted) {
+    esp_timer_start_periodic(clock_timer, 1000000);
+  } else {
+    esp_timer_stop(clock_timer);
+  }
+  clock_running = wanted;
 }
 
 void UIManager::loop() {
   bool first_run = true;
-  bool force_full_refresh = false;
-  int64_t last_ui_update = 0;
 
   while (1) {
-    // 1. Poll Inputs (every 50ms)
-    DeviceStatus current_status = global_data.getStatus();
-    updateButtonState(btn4, current_status.touch_4);
-    updateButtonState(btn5, current_status.touch_5);
-
-    bool need_redraw = false;
-
-    // 2. Handle Logic based on State
-    if (current_state == STATE_HOME) {
-      if (btn5.pressed) {
-        ESP_LOGI(TAG, "Entering Menu");
-        current_state = STATE_MENU;
-        selected_menu_index = 0;
-        // Fetch ASC status once when entering menu
-        if (scd4xManager) {
-          scd4xManager->getASCStatus(&asc_enabled);
-        }
-        need_redraw = true;
+    bool need_redraw = first_run;
+
+    if (!first_run) {
+      // Sleep until an event arrives or a gesture timeout expires. Pending
+      // prerender work wakes up after a short idle time instead.
+      UiEvent event;
+      TickType_t wait = gestureTimeout();
+      if (prerender_pending &&
+          wait > pdMS_TO_TICKS(READER_PRERENDER_DELAY_MS)) {
+        wait = pdMS_TO_TICKS(READER_PRERENDER_DELAY_MS);
       }
-
-      // Time based update for Home (every 1 sec)
-      int64_t now_us = esp_timer_get_time();
-      if ((now_us - last_ui_update) > 1000000) {
-        need_redraw = true;
-      }
-    } else if (current_state == STATE_MENU) {
-      if (btn4.pressed) {
-        // Cycle Selection
-        selected_menu_index = (selected_menu_index + 1) % menu_item_count;
-        need_redraw = true;
+      bool idle = !ui_events.receive(event, wait);
+      if (!idle) {
+        // Take everything already queued before timeouts are checked. A
+        // release that waited behind a slow frame has to reach its
+        // recognizer before poll() would turn the press into a hold.
+        do {
+          need_redraw |= handleEvent(event);
+          need_redraw |= dispatchGestures();
+        } while (ui_events.receive(event, 0));
       }
-      if (btn5.pressed) {
-        // Execute Action
-        if (selected_menu_index == 0) { // Back
-          current_state = STATE_HOME;
-          need_redraw = true;
-        } else if (selected_menu_index == 1) { // Refresh
-          force_full_refresh = true;           // Next draw will be full
-          current_state = STATE_HOME;
-          need_redraw = true;
-        } else if (selected_menu_index == 2) { // SCD41 Toggle ASC
-          if (scd4xManager)
-            scd4xManager->toggleASC();
-          current_state = STATE_HOME;
-          need_redraw = true;
-        } else if (selected_menu_index == 3) { // SCD41 FRC 430ppm
-          if (scd4xManager)
-            scd4xManager->performFRC(430);
-          current_state = STATE_HOME;
-          need_redraw = true;
-        } else if (selected_menu_index == 4) { // Reboot
-          esp_restart();
-        } else if (selected_menu_index == 5) { // Reader
-          current_state = STATE_READER;
-          loadProgress(); // Load saved page
-          need_redraw = true;
-        } else if (selected_menu_index == 6) { // Factory Reset
-          if (scd4xManager)
-            scd4xManager->performFactoryReset();
-          current_state = STATE_HOME;
-          need_redraw = true;
-        }
+      need_redraw |= processGestures();
+
+      // Catch completions whose event was dropped
+      if (updateSensorPending()) {
+        need_redraw |= (current_state == STATE_MENU);
       }
-    } else if (current_state == STATE_READER) {
-      // Button 5 Logic: Hold for Exit, Click for Back
-      if (current_status.touch_5) { // Button is held down
-        if (btn5_press_start_time == 0) {
-          btn5_press_start_time = esp_timer_get_time();
-          btn5_hold_triggered = false;
-        } else {
-          if (!btn5_hold_triggered &&
-              (esp_timer_get_time() - btn5_press_start_time > 1000000)) {
-            // Hold detected (> 1s) -> Exit
-            ESP_LOGI(TAG, "Hold detected: Exiting Reader");
-            saveProgress();
-            current_state = STATE_MENU;
-            need_redraw = true;
-            btn5_hold_triggered = true; // Prevent click action on release
-          }
-        }
-      } else { // Button is released
-        if (btn5_press_start_time != 0) {
-          // Falling edge
-          if (!btn5_hold_triggered &&
-              (esp_timer_get_time() - btn5_press_start_time < 1000000)) {
-            // Short press -> Previous Page
-            if (current_page_index > 0) {
-              current_page_index--;
-              saveProgress();
-              force_full_refresh = true;
-              need_redraw = true;
-            }
-          }
-          btn5_press_start_time = 0;
-          btn5_hold_triggered = false;
-        }
+      if (updateBookComplete()) {
+        need_redraw |= (current_state == STATE_READER);
       }
 
-      if (btn4.pressed) { // Next Page
-        if (!pages.empty()) {
-          if (current_page_index < pages.size() - 1) {
-            current_page_index++;
-            saveProgress();
-            force_full_refresh = true;
-            need_redraw = true;
-          }
-        }
+      // Prerender once the flush task has taken the last frame, so it runs
+      // while the panel refreshes
+      if (idle && !need_redraw && prerender_pending &&
+          !display->framePending()) {
+        prerenderReader();
       }
     }
 
-    // 3. Redraw if needed
-    if (need_redraw || first_run) {
+    // Redraw if needed
+    if (need_redraw) {
+      DeviceStatus current_status = global_data.getStatus();
       time_t now;
       struct tm timeinfo;
       time(&now);
       localtime_r(&now, &timeinfo);
 
+      // Hold the back buffer until the frame is complete, display() then
+      // hands it to the flush task without waiting for the panel
+      display->beginFrame();
+      int64_t render_start = esp_timer_get_time();
+      bool entering = !screen_valid || rendered_state != current_state;
       if (current_state == STATE_HOME) {
-        renderHome(current_status, &timeinfo);
+        renderHome(current_status, &timeinfo, entering);
       } else if (current_state == STATE_MENU) {
-        renderMenu();
+        renderMenu(entering);
       } else if (current_state == STATE_READER) {
         renderReader();
       }
-
-      ESP_LOGI(TAG, "Updating Display (Partial: %d)",
-               !(first_run || force_full_refresh));
-      display->display(!(first_run || force_full_refresh));
+      rendered_state = current_state;
+      screen_valid = true;
+      int64_t render_us = esp_timer_get_time() - render_start;
+      render_count++;
+      render_total_us += render_us;
+      ESP_LOGD(TAG, "Render took %lld us (avg %lld us over %lu frames)",
+               render_us, render_total_us / render_count, render_count);
+
+      // The refresh policy picks partial or full, the first frame is always
+      // full because nothing is known about the panel contents yet
+      RefreshQuality quality = screenQuality();
+      ESP_LOGI(TAG, "Updating Display (Quality: %d)", quality);
+      display->display(quality);
+      prerender_pending = (current_state == STATE_READER);
 
       first_run = false;
-      force_full_refresh = false;
-      last_ui_update = esp_timer_get_time();
     }
 
-    vTaskDelay(pdMS_TO_TICKS(50)); // Fast polling
+    updateClockTick();
   }
 }
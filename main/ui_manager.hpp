@@ -1,14 +1,27 @@
 #pragma once
 
+#include "book_reader.hpp"
+#include "book_store.hpp"
 #include "common_data.hpp"
+#include "data_bus.hpp"
 #include "display_manager.hpp"
 #include "esp_timer.h"
+#include "input_gestures.hpp"
+#include "page_cache.hpp"
+#include "scd4x_manager.hpp"
+#include "ui_events.hpp"
+#include "ui_widgets.hpp"
+#include <atomic>
 #include <string>
 #include <time.h>
 #include <vector>
 
+// Render static screen content once and restore it from a cached copy when
+// entering the screen or erasing widgets. Set to 0 to redraw it on entry and
+// erase widgets to white instead.
+#define UI_USE_STATIC_LAYERS 1
+
 class StorageManager;
-class Scd4xManager;
 
 class UIManager {
 public:
@@ -25,17 +38,44 @@ private:
   // Main loop
   void loop();
 
-  // Input handling
-  struct ButtonState {
-    bool last_state;
-    bool pressed;
-  };
-  void updateButtonState(ButtonState &btn, bool current);
+  // Event handling, each returns true if the screen needs a redraw
+  bool handleEvent(const UiEvent &event);
+  bool handleGesture(uint8_t button, const Gesture &gesture);
+  // Handle recognized gestures, processGestures() first fires expired
+  // timeouts
+  bool dispatchGestures();
+  bool processGestures();
+  // Queue wait until the next gesture timeout
+  TickType_t gestureTimeout() const;
+
+  // Sensor commands, completed asynchronously on the sensor task
+  static void sensorDone(const Scd4xResult &result, void *ctx);
+  void submitSensorCommand(Scd4xCommandType type, uint16_t arg = 0);
+  bool handleCommandResult(const UiEvent &event);
+
+  // Data bus subscription, forwards samples to the UI queue
+  static void dataCallback(const DataSample &sample, void *ctx);
 
-  // Rendering
-  void renderHome(const DeviceStatus &status, const struct tm *timeinfo);
-  void renderMenu();
+  // Second tick for the clock, runs only while the home screen is shown
+  static void clockTickCallback(void *arg);
+  void updateClockTick();
+
+  // Rendering. Widget screens take whether the back buffer still holds
+  // another screen and has to be reset first.
+  void buildScreens();
+  void renderHomeStatic();
+  void renderHome(const DeviceStatus &status, const struct tm *timeinfo,
+                  bool entering);
+  void renderMenu(bool entering);
   void renderReader();
+  bool openBook();
+  void drawReaderPage(uint32_t offset, const BookPosition &pos);
+
+  // Render one page next to the current one ahead of time, while idle
+  void prerenderReader();
+
+  // Refresh quality the current screen needs
+  RefreshQuality screenQuality() const;
 
   // Members
   Adafruit_SSD1680 *display;
@@ -48,16 +88,67 @@ private:
   bool asc_enabled;
 
   // Reader State
-  std::vector<std::string> pages;
-  int current_page_index;
-  void paginateContent(const std::string &content);
+  BookStore book_store;
+  BookReader book;
+  uint32_t reader_offset; // Start of the current page in the book
+  PageCache page_cache;
+  bool reader_turned;     // The next reader render follows a page turn
+  bool prerender_pending; // Neighbour pages may still need prerendering
+  bool book_complete;     // Pagination finish already seen by the UI task
+  int32_t legacy_page;    // Page number saved by older versions, -1 if none
+  static void bookReady(void *ctx);
+  // Pick up a finished pagination, true if the state changed since the last
+  // call. Catches completions whose event was dropped.
+  bool updateBookComplete();
   void saveProgress();
   void loadProgress();
+  // Turn legacy_page into reader_offset once pagination got there
+  void migrateProgress();
+
+  // Screen currently on the back buffer
+  AppState rendered_state;
+  bool screen_valid;
+
+  // Cached home screen background (labels and icons)
+  uint8_t *home_layer;
+  bool home_layer_valid;
+
+  // Sensor commands in flight and the last result message. Completions are
+  // counted on the sensor task before their event is posted, so a dropped
+  // event cannot leave a command pending forever.
+  uint32_t sensor_submitted;
+  std::atomic<uint32_t> sensor_completed;
+  int sensor_pending;
+  bool updateSensorPending();
+  bool asc_known;
+  char menu_status_text[24];
+
+  // Home screen widgets
+  WidgetScreen home_screen;
+  TextWidget co2_text;
+  TextWidget temp_text;
+  TextWidget hum_text;
+  TextWidget alt_text;
+  TextWidget time_text;
+  TextWidget battery_text;
+  TextWidget touch4_text;
+  TextWidget touch5_text;
+  IconWidget check_icon;
+
+  // Menu widgets
+  WidgetScreen menu_screen;
+  TextWidget menu_title;
+  TextWidget menu_status;
+  ListWidget menu_list;
+
+  // Render time measurement
+  uint32_t render_count;
+  int64_t render_total_us;
 
-  ButtonState btn4;
-  ButtonState btn5;
+  esp_timer_handle_t clock_timer;
+  bool clock_running;
 
-  // Button Hold Tracking
-  int64_t btn5_press_start_time;
-  bool btn5_hold_triggered;
+  // Gestures per button, indexed like UiButton
+  GestureRecognizer touch4_gestures;
+  GestureRecognizer btn5_gestures;
 };
@@ -0,0 +1,204 @@
+#include "ui_widgets.hpp"
+
+void UiRect::unite(const UiRect &other) {
+  if (other.empty())
+    return;
+  if (empty()) {
+    *this = other;
+    return;
+  }
+  int16_t x1 = (x + w > other.x + other.w) ? x + w : other.x + other.w;
+  int16_t y1 = (y + h > other.y + other.h) ? y + h : other.y + other.h;
+  x = (x < other.x) ? x : other.x;
+  y = (y < other.y) ? y : other.y;
+  w = x1 - x;
+  h = y1 - y;
+}
+
+// --- Widget ---
+
+UiRect Widget::render(Adafruit_SSD1680 *display, const uint8_t *background) {
+  UiRect area = {0, 0, 0, 0};
+  if (!dirty)
+    return area;
+
+  // Erase the previous content
+  if (!drawn.empty()) {
+    if (background) {
+      display->loadLayerRect(background, drawn.x, drawn.y, drawn.w, drawn.h);
+    } else {
+      display->fillRect(drawn.x, drawn.y, drawn.w, drawn.h, GFX_WHITE);
+    }
+  }
+  area = drawn;
+
+  drawn = measure(display);
+  draw(display);
+  area.unite(drawn);
+  dirty = false;
+  return area;
+}
+
+// --- TextWidget ---
+
+TextWidget::TextWidget(int16_t x, int16_t y, const GFXfont *font,
+                       TextAlign align)
+    : x(x), y(y), font(font), align(align) {}
+
+void TextWidget::setText(const char *value) {
+  if (text != value) {
+    text = value;
+    dirty = true;
+  }
+}
+
+UiRect TextWidget::measure(Adafruit_SSD1680 *display) {
+  UiRect bounds = {0, 0, 0, 0};
+  if (text.empty())
+    return bounds;
+
+  int16_t x1, y1;
+  uint16_t w, h;
+  display->setFont(font);
+  display->getTextBounds(text.c_str(), 0, 0, &x1, &y1, &w, &h);
+  // Right Edge = CursorX + OffsetX + Width, see printRightAligned
+  int16_t cursor_x = (align == ALIGN_RIGHT) ? x - w - x1 : x;
+  bounds = {(int16_t)(cursor_x + x1), (int16_t)(y + y1), (int16_t)w,
+            (int16_t)h};
+  return bounds;
+}
+
+void TextWidget::draw(Adafruit_SSD1680 *display) {
+  if (text.empty())
+    return;
+
+  display->setFont(font);
+  if (align == ALIGN_RIGHT) {
+    display->printRightAligned(x, y, text.c_str());
+  } else {
+    display->setCursor(x, y);
+    display->print(text.c_str());
+  }
+}
+
+// --- IconWidget ---
+
+IconWidget::IconWidget(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w,
+                       int16_t h)
+    : x(x), y(y), w(w), h(h), bitmap(bitmap), visible(true) {}
+
+void IconWidget::setVisible(bool value) {
+  if (visible != value) {
+    visible = value;
+    dirty = true;
+  }
+}
+
+UiRect IconWidget::measure(Adafruit_SSD1680 *display) {
+  UiRect bounds = {x, y, w, h};
+  if (!visible) {
+    bounds.w = 0;
+  }
+  return bounds;
+}
+
+void IconWidget::draw(Adafruit_SSD1680 *display) {
+  if (visible) {
+    display->drawBitmap(x, y, bitmap, w, h, GFX_BLACK);
+  }
+}
+
+// --- ListWidget ---
+
+ListWidget::ListWidget(int16_t x, int16_t y, int16_t line_height,
+                       const GFXfont *font)
+    : x(x), y(y), line_height(line_height), font(font), selected(0) {}
+
+void ListWidget::setItemCount(int count) {
+  items.resize(count);
+  rows.clear();
+  for (int i = 0; i < count; i++) {
+    rows.emplace_back(x, y + i * line_height, font);
+  }
+  dirty = true;
+}
+
+void ListWidget::updateRow(int index) {
+  std::string line = (index == selected) ? "> " : "  ";
+  line += items[index];
+  rows[index].setText(line.c_str());
+  if (rows[index].isDirty()) {
+    dirty = true;
+  }
+}
+
+void ListWidget::setItem(int index, const char *text) {
+  if (index < 0 || index >= (int)items.size() || items[index] == text)
+    return;
+  items[index] = text;
+  updateRow(index);
+}
+
+void ListWidget::setSelected(int index) {
+  if (index == selected)
+    return;
+  int previous = selected;
+  selected = index;
+  if (previous >= 0 && previous < (int)items.size()) {
+    updateRow(previous);
+  }
+  if (selected >= 0 && selected < (int)items.size()) {
+    updateRow(selected);
+  }
+}
+
+void ListWidget::invalidate() {
+  for (TextWidget &row : rows) {
+    row.invalidate();
+  }
+  dirty = true;
+}
+
+UiRect ListWidget::render(Adafruit_SSD1680 *display,
+                          const uint8_t *background) {
+  UiRect area = {0, 0, 0, 0};
+  if (!dirty)
+    return area;
+
+  for (size_t i = 0; i < rows.size(); i++) {
+    if (rows[i].getText().empty()) {
+      updateRow(i);
+    }
+    area.unite(rows[i].render(display, background));
+  }
+  dirty = false;
+  return area;
+}
+
+UiRect ListWidget::measure(Adafruit_SSD1680 *display) {
+  return {x, y, 0, (int16_t)(rows.size() * line_height)};
+}
+
+void ListWidget::draw(Adafruit_SSD1680 *display) {
+  // Rows draw themselves in render()
+}
+
+// --- WidgetScreen ---
+
+WidgetScreen::WidgetScreen() : background(nullptr) {}
+
+void WidgetScreen::add(Widget *widget) { widgets.push_back(widget); }
+
+void WidgetScreen::invalidateAll() {
+  for (Widget *widget : widgets) {
+    widget->invalidate();
+  }
+}
+
+UiRect WidgetScreen::render(Adafruit_SSD1680 *display) {
+  UiRect dirty_region = {0, 0, 0, 0};
+  for (Widget *widget : widgets) {
+    dirty_region.unite(widget->render(display, background));
+  }
+  return dirty_region;
+}
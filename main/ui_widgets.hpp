@@ -0,0 +1,150 @@
+#pragma once
+
+#include "display_manager.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * @brief Rectangle in logical (rotated) screen coordinates
+ */
+struct UiRect {
+  int16_t x, y, w, h;
+
+  bool empty() const { return w <= 0 || h <= 0; }
+  void unite(const UiRect &other);
+};
+
+/**
+ * @brief Retained-mode widget with change detection
+ *
+ * Setters invalidate the widget only when the value really changes. A
+ * render pass repaints invalidated widgets only, restoring the screen
+ * background behind their previous content first.
+ */
+class Widget {
+public:
+  virtual ~Widget() {}
+
+  virtual void invalidate() { dirty = true; }
+  bool isDirty() const { return dirty; }
+
+  /**
+   * @brief Repaint the widget if it was invalidated
+   * @param display Target display
+   * @param background Layer restored behind old content, nullptr for white
+   * @return Union of old and new bounds, empty if nothing was repainted
+   */
+  virtual UiRect render(Adafruit_SSD1680 *display, const uint8_t *background);
+
+protected:
+  // Bounds the current value will cover
+  virtual UiRect measure(Adafruit_SSD1680 *display) = 0;
+  virtual void draw(Adafruit_SSD1680 *display) = 0;
+
+  bool dirty = true;
+  UiRect drawn = {0, 0, 0, 0}; // Area covered by the last paint
+};
+
+enum TextAlign { ALIGN_LEFT, ALIGN_RIGHT };
+
+/**
+ * @brief Single line of text, left aligned at or right aligned to x
+ */
+class TextWidget : public Widget {
+public:
+  TextWidget(int16_t x, int16_t y, const GFXfont *font,
+             TextAlign align = ALIGN_LEFT);
+
+  void setText(const char *value);
+  const std::string &getText() const { return text; }
+
+protected:
+  UiRect measure(Adafruit_SSD1680 *display) override;
+  void draw(Adafruit_SSD1680 *display) override;
+
+private:
+  int16_t x, y;
+  const GFXfont *font;
+  TextAlign align;
+  std::string text;
+};
+
+/**
+ * @brief Monochrome bitmap that can be shown or hidden
+ */
+class IconWidget : public Widget {
+public:
+  IconWidget(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w,
+             int16_t h);
+
+  void setVisible(bool value);
+
+protected:
+  UiRect measure(Adafruit_SSD1680 *display) override;
+  void draw(Adafruit_SSD1680 *display) override;
+
+private:
+  int16_t x, y, w, h;
+  const uint8_t *bitmap;
+  bool visible;
+};
+
+/**
+ * @brief Vertical list with a "> " cursor on the selected row
+ *
+ * Rows are independent text widgets, so moving the cursor repaints only the
+ * previously and newly selected rows.
+ */
+class ListWidget : public Widget {
+public:
+  ListWidget(int16_t x, int16_t y, int16_t line_height, const GFXfont *font);
+
+  void setItemCount(int count);
+  void setItem(int index, const char *text);
+  void setSelected(int index);
+
+  // Also invalidates every row, they repaint independently
+  void invalidate() override;
+
+  UiRect render(Adafruit_SSD1680 *display,
+                const uint8_t *background) override;
+
+protected:
+  UiRect measure(Adafruit_SSD1680 *display) override;
+  void draw(Adafruit_SSD1680 *display) override;
+
+private:
+  int16_t x, y, line_height;
+  const GFXfont *font;
+  int selected;
+  std::vector<std::string> items;
+  std::vector<TextWidget> rows;
+
+  void updateRow(int index);
+};
+
+/**
+ * @brief Set of widgets sharing one background layer
+ */
+class WidgetScreen {
+public:
+  WidgetScreen();
+
+  void add(Widget *widget);
+  void setBackground(const uint8_t *layer) { background = layer; }
+
+  /**
+   * @brief Mark every widget for repaint, e.g. after entering the screen
+   */
+  void invalidateAll();
+
+  /**
+   * @brief Repaint invalidated widgets
+   * @return Union of repainted areas, the frame's dirty region
+   */
+  UiRect render(Adafruit_SSD1680 *display);
+
+private:
+  std::vector<Widget *> widgets;
+  const uint8_t *background;
+};
@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""Pack text books into an image for the read-only "books" partition.
+
+The image starts with a header and a directory, followed by the books.
+The layout matches BookStoreHeader and BookStoreEntry in
+main/book_store.hpp:
+
+    uint32 magic ("BKS1"), uint32 count
+    count x { char name[32], uint32 offset, uint32 size, uint32 crc32 }
+    book data, each book 4-byte aligned
+
+All values are little-endian, offsets are from the start of the image.
+
+Each .txt book is stored block-compressed as <name>.bkz, see
+tools/pack_bkz.py, unless --plain is given. With --stage the tool also
+mirrors a LittleFS data directory without its .txt books, so every book is
+flashed once, into the books partition.
+"""
+
+import argparse
+import os
+import shutil
+import struct
+import sys
+import zlib
+
+from pack_bkz import BLOCK_SIZE, compress
+
+MAGIC = 0x31534B42
+NAME_LEN = 32
+ALIGN = 4
+
+
+def pack(paths, size_limit, plain, block_size):
+    books = []
+    for path in sorted(paths):
+        with open(path, "rb") as f:
+            content = f.read()
+        name = os.path.basename(path)
+        if not plain and name.endswith(".txt"):
+            size = len(content)
+            content = compress(content, block_size)
+            name = name[:-len(".txt")] + ".bkz"
+            print(f"pack_books: {name} {size} -> {len(content)} bytes")
+        name = name.encode("utf-8")
+        if len(name) >= NAME_LEN:
+            sys.exit(f"pack_books: name too long: {path}")
+        books.append((name, content))
+
+    header = struct.pack("<II", MAGIC, len(books))
+    directory_size = len(books) * (NAME_LEN + 12)
+    offset = len(header) + directory_size
+
+    directory = b""
+    data = b""
+    for name, content in books:
+        padding = -offset % ALIGN
+        data += b"\0" * padding
+        offset += padding
+        directory += struct.pack(f"<{NAME_LEN}sIII", name, offset,
+                                 len(content),
+                                 zlib.crc32(content) & 0xFFFFFFFF)
+        data += content
+        offset += len(content)
+
+    image = header + directory + data
+    if size_limit and len(image) > size_limit:
+        sys.exit(f"pack_books: image is {len(image)} bytes, "
+                 f"partition holds {size_limit}")
+    return image
+
+
+def stage(input_dir, output_dir):
+    if os.path.isdir(output_dir):
+        shutil.rmtree(output_dir)
+    for root, _, files in os.walk(input_dir):
+        target = os.path.join(output_dir, os.path.relpath(root, input_dir))
+        os.makedirs(target, exist_ok=True)
+        for name in sorted(files):
+            if not name.endswith(".txt"):
+                shutil.copy2(os.path.join(root, name),
+                             os.path.join(target, name))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("-o", "--output", help="image file")
+    parser.add_argument("--size", type=lambda s: int(s, 0), default=0,
+                        help="partition size to check against")
+    parser.add_argument("--plain", action="store_true",
+                        help="store the texts uncompressed")
+    parser.add_argument("--block-size", type=int, default=BLOCK_SIZE,
+                        help=f"text bytes per compressed block, default "
+                             f"{BLOCK_SIZE}")
+    parser.add_argument("--stage", nargs=2, metavar=("INPUT_DIR", "OUTPUT_DIR"),
+                        help="mirror a data directory without its .txt books")
+    parser.add_argument("--stamp", help="file to touch when done")
+    parser.add_argument("books", nargs="*", help="text files to pack")
+    args = parser.parse_args()
+
+    if not args.output and not args.stage:
+        parser.error("nothing to do")
+    if args.output:
+        image = pack(args.books, args.size, args.plain, args.block_size)
+        with open(args.output, "wb") as f:
+            f.write(image)
+        print(f"pack_books: {len(args.books)} books, {len(image)} bytes")
+    if args.stage:
+        stage(*args.stage)
+    if args.stamp:
+        with open(args.stamp, "w"):
+            pass
+
+
+if __name__ == "__main__":
+    main()